@@ -4,8 +4,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
 #include <time.h>
 #include "md5.h" /* 引入MD5模块 */
+#include "sort_kernels.h"
+#include "radix_sort.h"
+#include "parallel_sort.h"
+#include "sort_simd.h"
+#include "string_sort.h"
+#include "string_pool.h"
+#include "external_sort.h"
+#include "stable_sort.h"
+#include "fast_input.h"
+#include "fast_output.h"
+#include "timer.h"
+#include "perf_counters.h"
+#include "counter_rng.h"
 
 /* ===================== 类型定义 ===================== */
 typedef struct {
@@ -19,17 +33,44 @@ typedef enum {
     SORT_FLOAT,
     SORT_DOUBLE,
     SORT_STRING,
-    SORT_STRUCT
+    SORT_STRUCT,
+    SORT_STRING_POOL  /* 字符串池：元素为StringPoolEntry，字节集中存放在pool中 */
 } SortType;
 
+/* 排序算法选择 */
+typedef enum {
+    SORT_ALGO_INTRO,     /* 内省排序：快速排序 + 堆排序兜底 + 小分区插入排序 */
+    SORT_ALGO_HEAP,      /* 堆排序 */
+    SORT_ALGO_INSERTION, /* 插入排序 */
+    SORT_ALGO_BUBBLE,    /* 冒泡排序 */
+    SORT_ALGO_RADIX,     /* LSD基数排序，仅数值类型；其他类型退回内省排序 */
+    SORT_ALGO_PARALLEL,  /* 多线程样本排序，桶内使用内省排序内核（字符串用专用引擎） */
+    SORT_ALGO_MULTIKEY,  /* 字符串专用：MSD基数 + 多键快速排序；其他类型退回内省排序 */
+    SORT_ALGO_PACKED,    /* 结构体专用：打包整数键排序后一次置换记录；其他类型退回内省排序 */
+    SORT_ALGO_STABLE     /* 稳定自适应归并排序：利用已有顺串，部分有序输入接近线性 */
+} SortAlgorithm;
+
 typedef struct {
     void* data;
     size_t size;
     size_t capacity;
+    size_t element_size; /* 创建时按类型确定，插入与排序不再逐次分派 */
     SortType type;
+    SortAlgorithm algorithm;
+    int threads;         /* 并行排序线程数，0表示使用全部在线CPU */
+    StringPool* pool;    /* 仅SORT_STRING_POOL使用 */
+    StableSortBuffer merge_buffer; /* 稳定排序与增量归并的缓冲区，跨次排序复用 */
+    int incremental;     /* 增量模式：[0, sorted)保持有序，新元素先追加到尾部缓冲区 */
+    size_t sorted;
+    size_t tail_limit;   /* 尾部达到该长度时归并；0表示随有序区增长 */
     uint8_t (*hash)(const void*);
 } SortArray;
 
+/* 小于该长度的分区改用插入排序 */
+#define SORT_INSERTION_THRESHOLD 16
+
+#define SORT_ELEM(base, i, size) ((char*)(base) + (size_t)(i) * (size))
+
 static void sort_swap(void* a, void* b, size_t size) {
     char temp[size];
     memcpy(temp, a, size);
@@ -47,11 +88,16 @@ static int compare_int(const void* a, const void* b) {
 }
 
 static int compare_float(const void* a, const void* b) {
-    return (*(const float*)a > *(const float*)b) ? 1 : -1;
+    // 相等时必须返回0，否则快速排序的分区扫描会越界
+    float val_a = *(const float*)a;
+    float val_b = *(const float*)b;
+    return (val_a > val_b) - (val_a < val_b);
 }
 
 static int compare_double(const void* a, const void* b) {
-    return (*(const double*)a > *(const double*)b) ? 1 : -1;
+    double val_a = *(const double*)a;
+    double val_b = *(const double*)b;
+    return (val_a > val_b) - (val_a < val_b);
 }
 
 static int compare_string(const void* a, const void* b) {
@@ -68,6 +114,99 @@ static int compare_struct(const void* a, const void* b) {
     return (s1->hash < s2->hash) ? -1 : (s1->hash > s2->hash);
 }
 
+/* 类型特化内核：比较与交换在编译期内联，按SortArray.type一次分派 */
+#define SORT_LESS_SCALAR(a, b) (*(a) < *(b))
+#define SORT_LESS_STRING(a, b) (strcmp(*(a), *(b)) < 0)
+#define SORT_LESS_STRUCT(a, b) (compare_struct((a), (b)) < 0)
+
+/* int与double的小分区交给AVX2排序网络（不支持时内部退回插入排序） */
+SORT_DEFINE_KERNELS_LEAF(int, int, SORT_LESS_SCALAR, SORT_SIMD_INT_BLOCK, sort_simd_small_int)
+SORT_DEFINE_KERNELS(float, float, SORT_LESS_SCALAR)
+SORT_DEFINE_KERNELS_LEAF(double, double, SORT_LESS_SCALAR, SORT_SIMD_DOUBLE_BLOCK, sort_simd_small_double)
+SORT_DEFINE_KERNELS(string, char*, SORT_LESS_STRING)
+SORT_DEFINE_KERNELS(struct, TestData, SORT_LESS_STRUCT)
+
+/* 选择与部分排序内核 */
+SORT_DEFINE_SELECT(int, int, SORT_LESS_SCALAR)
+SORT_DEFINE_SELECT(float, float, SORT_LESS_SCALAR)
+SORT_DEFINE_SELECT(double, double, SORT_LESS_SCALAR)
+SORT_DEFINE_SELECT(string, char*, SORT_LESS_STRING)
+SORT_DEFINE_SELECT(struct, TestData, SORT_LESS_STRUCT)
+
+/* 字符串池条目的比较需要池上下文，选择时临时配上字符串地址 */
+typedef struct {
+    const char* str;
+    StringPoolEntry entry;
+} SortPoolRef;
+
+static inline int sort_pool_ref_less(const SortPoolRef* a, const SortPoolRef* b) {
+    if (a->entry.prefix != b->entry.prefix) return a->entry.prefix < b->entry.prefix;
+    return strcmp(a->str, b->str) < 0;
+}
+
+#define SORT_LESS_POOL_REF(a, b) sort_pool_ref_less((a), (b))
+
+SORT_DEFINE_KERNELS(pool_ref, SortPoolRef, SORT_LESS_POOL_REF)
+SORT_DEFINE_SELECT(pool_ref, SortPoolRef, SORT_LESS_POOL_REF)
+
+/*
+ * 结构体打包键：名字前12字节按大端装入hi与lo的高32位，lo的低32位放hash，
+ * 整数比较的结果与compare_struct一致。名字不短于12字节时前缀不能决定顺序，
+ * lo的低32位置0，键相同时回到compare_struct比较原记录。
+ */
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+    const TestData* rec;
+} SortPackedKey;
+
+/* 内核的LESS参数可能带副作用（如&base[--j]），比较写成函数只求值一次 */
+static inline int sort_packed_less(const SortPackedKey* a, const SortPackedKey* b) {
+    if (a->hi != b->hi) return a->hi < b->hi;
+    if (a->lo != b->lo) return a->lo < b->lo;
+    return compare_struct(a->rec, b->rec) < 0;
+}
+
+#define SORT_LESS_PACKED(a, b) sort_packed_less((a), (b))
+
+SORT_DEFINE_KERNELS(packed, SortPackedKey, SORT_LESS_PACKED)
+
+static void sort_packed_key(SortPackedKey* key, const TestData* rec) {
+    uint8_t prefix[12] = {0};
+    size_t len = strnlen(rec->name, sizeof(rec->name));
+    memcpy(prefix, rec->name, len < sizeof(prefix) ? len : sizeof(prefix));
+    key->hi = 0;
+    for (int i = 0; i < 8; i++)
+        key->hi = (key->hi << 8) | prefix[i];
+    key->lo = 0;
+    for (int i = 8; i < 12; i++)
+        key->lo = (key->lo << 8) | prefix[i];
+    key->lo <<= 32;
+    if (len < sizeof(prefix))
+        key->lo |= rec->hash;
+    key->rec = rec;
+}
+
+/* 生成键、排序键，再按键的顺序把记录整体搬运一次；内存不足返回-1（数据不变） */
+static int sort_packed_struct(TestData* data, size_t n) {
+    SortPackedKey* keys = malloc(n * sizeof(SortPackedKey));
+    TestData* sorted = malloc(n * sizeof(TestData));
+    if (!keys || !sorted) {
+        free(keys);
+        free(sorted);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++)
+        sort_packed_key(&keys[i], &data[i]);
+    sort_intro_packed(keys, n);
+    for (size_t i = 0; i < n; i++)
+        sorted[i] = *keys[i].rec;
+    memcpy(data, sorted, n * sizeof(TestData));
+    free(sorted);
+    free(keys);
+    return 0;
+}
+
 static void sort_bubble(void* base, size_t nmemb, size_t size,
                        int (*compar)(const void*, const void*)) {
     for (size_t i = 0; i < nmemb - 1; i++) {
@@ -79,15 +218,139 @@ static void sort_bubble(void* base, size_t nmemb, size_t size,
     }
 }
 
+static void sort_insertion(void* base, size_t nmemb, size_t size,
+                           int (*compar)(const void*, const void*)) {
+    for (size_t i = 1; i < nmemb; i++) {
+        for (size_t j = i; j > 0; j--) {
+            char* cur = SORT_ELEM(base, j, size);
+            if (compar(cur - size, cur) <= 0) break;
+            sort_swap(cur - size, cur, size);
+        }
+    }
+}
+
+static void sort_sift_down(void* base, size_t root, size_t nmemb, size_t size,
+                           int (*compar)(const void*, const void*)) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= nmemb) break;
+        if (child + 1 < nmemb &&
+            compar(SORT_ELEM(base, child, size), SORT_ELEM(base, child + 1, size)) < 0)
+            child++;
+        if (compar(SORT_ELEM(base, root, size), SORT_ELEM(base, child, size)) >= 0) break;
+        sort_swap(SORT_ELEM(base, root, size), SORT_ELEM(base, child, size), size);
+        root = child;
+    }
+}
+
+static void sort_heap(void* base, size_t nmemb, size_t size,
+                      int (*compar)(const void*, const void*)) {
+    if (nmemb < 2) return;
+    for (size_t i = nmemb / 2; i-- > 0; )
+        sort_sift_down(base, i, nmemb, size, compar);
+    for (size_t end = nmemb - 1; end > 0; end--) {
+        sort_swap(base, SORT_ELEM(base, end, size), size);
+        sort_sift_down(base, 0, end, size, compar);
+    }
+}
+
+/* 返回a、b、c三者的中位数 */
+static char* sort_median3(char* a, char* b, char* c,
+                          int (*compar)(const void*, const void*)) {
+    return compar(a, b) < 0
+        ? (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a))
+        : (compar(b, c) > 0 ? b : (compar(a, c) > 0 ? c : a));
+}
+
+static void sort_intro_loop(char* base, size_t nmemb, size_t size,
+                            int (*compar)(const void*, const void*), int depth) {
+    while (nmemb > SORT_INSERTION_THRESHOLD) {
+        if (depth-- == 0) {
+            // 递归过深说明分区持续失衡，改用堆排序保证O(n log n)
+            sort_heap(base, nmemb, size, compar);
+            return;
+        }
+
+        char* lo = base;
+        char* mid = SORT_ELEM(base, nmemb / 2, size);
+        char* hi = SORT_ELEM(base, nmemb - 1, size);
+        if (nmemb > 128) {
+            // 大分区用九数取中，降低遇到有序/管道形数据时的退化概率
+            size_t step = (nmemb / 8) * size;
+            lo = sort_median3(lo, lo + step, lo + 2 * step, compar);
+            mid = sort_median3(mid - step, mid, mid + step, compar);
+            hi = sort_median3(hi - 2 * step, hi - step, hi, compar);
+        }
+        sort_swap(base, sort_median3(lo, mid, hi, compar), size);
+
+        // Hoare分区，枢轴位于base[0]；与枢轴相等的元素两侧都会停下，重复值多时依然均衡
+        size_t i = 0, j = nmemb;
+        for (;;) {
+            while (++i < nmemb && compar(SORT_ELEM(base, i, size), base) < 0);
+            while (compar(SORT_ELEM(base, --j, size), base) > 0);
+            if (i >= j) break;
+            sort_swap(SORT_ELEM(base, i, size), SORT_ELEM(base, j, size), size);
+        }
+        sort_swap(base, SORT_ELEM(base, j, size), size);
+
+        // 先递归较小的一侧，较大的一侧循环处理，栈深度为O(log n)
+        size_t left = j, right = nmemb - j - 1;
+        if (left < right) {
+            sort_intro_loop(base, left, size, compar, depth);
+            base = SORT_ELEM(base, j + 1, size);
+            nmemb = right;
+        } else {
+            sort_intro_loop(SORT_ELEM(base, j + 1, size), right, size, compar, depth);
+            nmemb = left;
+        }
+    }
+    sort_insertion(base, nmemb, size, compar);
+}
+
+/* 内省排序：与sort_bubble同签名，不稳定，要求compar对相等元素返回0 */
+static void sort_intro(void* base, size_t nmemb, size_t size,
+                       int (*compar)(const void*, const void*)) {
+    int depth = 0;
+    for (size_t n = nmemb; n > 1; n >>= 1)
+        depth += 2;
+    sort_intro_loop(base, nmemb, size, compar, depth);
+}
+
 /* ===================== 内存管理模块 ===================== */
+static size_t sort_element_size(SortType type) {
+    switch(type) {
+        case SORT_INT: return sizeof(int);
+        case SORT_FLOAT: return sizeof(float);
+        case SORT_DOUBLE: return sizeof(double);
+        case SORT_STRING: return sizeof(char*);
+        case SORT_STRUCT: return sizeof(TestData);
+        case SORT_STRING_POOL: return sizeof(StringPoolEntry);
+        default: return 0;
+    }
+}
+
 SortArray* sort_array_create(SortType type) {
     SortArray* arr = malloc(sizeof(SortArray));
     arr->data = NULL;
     arr->size = 0;
     arr->capacity = 0;
+    arr->element_size = sort_element_size(type);
     arr->type = type;
+    arr->algorithm = SORT_ALGO_INTRO;
+    arr->threads = 0;
+    arr->pool = NULL;
+    arr->merge_buffer.data = NULL;
+    arr->merge_buffer.bytes = 0;
+    arr->incremental = 0;
+    arr->sorted = 0;
+    arr->tail_limit = 0;
     
     switch(type) {
+        case SORT_STRING_POOL:
+            arr->hash = NULL;
+            arr->pool = malloc(sizeof(StringPool));
+            string_pool_init(arr->pool, 0);
+            break;
         case SORT_STRUCT:
             arr->hash = NULL;  // 我们在插入时计算哈希值
             break;
@@ -97,31 +360,406 @@ SortArray* sort_array_create(SortType type) {
     return arr;
 }
 
+void sort_array_set_algorithm(SortArray* arr, SortAlgorithm algorithm) {
+    arr->algorithm = algorithm;
+}
+
+void sort_array_set_threads(SortArray* arr, int threads) {
+    arr->threads = threads;
+}
+
+static int (*sort_comparator(SortType type))(const void*, const void*) {
+    switch(type) {
+        case SORT_INT: return compare_int;
+        case SORT_FLOAT: return compare_float;
+        case SORT_DOUBLE: return compare_double;
+        case SORT_STRING: return compare_string;
+        case SORT_STRUCT: return compare_struct;
+        default: return NULL;
+    }
+}
+
+/* 使用比较函数按数组选定的算法排序base起的n个元素（通用路径） */
+static void sort_region_by(SortArray* arr, void* base, size_t n,
+                           int (*compar)(const void*, const void*)) {
+    size_t element_size = arr->element_size;
+    if (n < 2 || !compar || !element_size) return;
+
+    switch(arr->algorithm) {
+        case SORT_ALGO_HEAP:
+            sort_heap(base, n, element_size, compar);
+            break;
+        case SORT_ALGO_INSERTION:
+            sort_insertion(base, n, element_size, compar);
+            break;
+        case SORT_ALGO_BUBBLE:
+            sort_bubble(base, n, element_size, compar);
+            break;
+        case SORT_ALGO_STABLE:
+            // 归并缓冲区分配失败时退回同样稳定的插入排序
+            if (stable_sort(base, n, element_size, compar, &arr->merge_buffer) != 0)
+                sort_insertion(base, n, element_size, compar);
+            break;
+        case SORT_ALGO_PARALLEL:
+            if (parallel_sample_sort(base, n, element_size, compar,
+                                     sort_intro, arr->threads) == 0)
+                break;
+            sort_intro(base, n, element_size, compar);
+            break;
+        case SORT_ALGO_INTRO:
+        default:
+            sort_intro(base, n, element_size, compar);
+    }
+}
+
+#define SORT_RUN_KERNEL(name, T, arr, base, n)                         \
+    switch((arr)->algorithm) {                                         \
+        case SORT_ALGO_HEAP:                                           \
+            sort_heap_##name((T*)(base), (n));                         \
+            break;                                                     \
+        case SORT_ALGO_INSERTION:                                      \
+            sort_insertion_##name((T*)(base), (n));                    \
+            break;                                                     \
+        default:                                                       \
+            sort_intro_##name((T*)(base), (n));                        \
+    }
+
+static void sort_bucket_string(void* base, size_t nmemb, size_t size,
+                               int (*compar)(const void*, const void*)) {
+    (void)size;
+    (void)compar;
+    string_sort((char**)base, nmemb);
+}
+
+static ParallelBucketSort sort_bucket_kernel(SortType type) {
+    switch(type) {
+        case SORT_INT: return sort_kernel_int;
+        case SORT_FLOAT: return sort_kernel_float;
+        case SORT_DOUBLE: return sort_kernel_double;
+        case SORT_STRING: return sort_bucket_string;
+        case SORT_STRUCT: return sort_kernel_struct;
+        default: return NULL;
+    }
+}
+
+/* 按数组选定的算法排序base起的n个元素；冒泡排序保留通用实现作为参照，稳定排序只有通用实现 */
+static void sort_region(SortArray* arr, void* base, size_t n) {
+    if (n < 2) return;
+    // 字符串池的比较需要池上下文，始终使用池专用排序
+    if (arr->type == SORT_STRING_POOL) {
+        string_pool_sort(arr->pool, (StringPoolEntry*)base, n);
+        return;
+    }
+    if (arr->algorithm == SORT_ALGO_BUBBLE || arr->algorithm == SORT_ALGO_STABLE) {
+        sort_region_by(arr, base, n, sort_comparator(arr->type));
+        return;
+    }
+
+    if (arr->algorithm == SORT_ALGO_RADIX) {
+        int rc = -1;
+        switch(arr->type) {
+            case SORT_INT: rc = radix_sort_int((int*)base, n); break;
+            case SORT_FLOAT: rc = radix_sort_float((float*)base, n); break;
+            case SORT_DOUBLE: rc = radix_sort_double((double*)base, n); break;
+            default: break;
+        }
+        if (rc == 0) return;
+    }
+
+    if (arr->algorithm == SORT_ALGO_MULTIKEY && arr->type == SORT_STRING) {
+        string_sort((char**)base, n);
+        return;
+    }
+
+    if (arr->algorithm == SORT_ALGO_PACKED && arr->type == SORT_STRUCT &&
+        sort_packed_struct((TestData*)base, n) == 0)
+        return;
+
+    // 并行排序：分类用比较函数，桶内用类型特化内核；失败时退回单线程内核
+    if (arr->algorithm == SORT_ALGO_PARALLEL &&
+        parallel_sample_sort(base, n, arr->element_size,
+                             sort_comparator(arr->type), sort_bucket_kernel(arr->type),
+                             arr->threads) == 0)
+        return;
+
+    switch(arr->type) {
+        case SORT_INT: SORT_RUN_KERNEL(int, int, arr, base, n); break;
+        case SORT_FLOAT: SORT_RUN_KERNEL(float, float, arr, base, n); break;
+        case SORT_DOUBLE: SORT_RUN_KERNEL(double, double, arr, base, n); break;
+        case SORT_STRING: SORT_RUN_KERNEL(string, char*, arr, base, n); break;
+        case SORT_STRUCT: SORT_RUN_KERNEL(struct, TestData, arr, base, n); break;
+        default: break;
+    }
+}
+
+/* 使用自定义比较函数，按数组选定的算法排序；增量模式下之后的归并会先整体重排 */
+void sort_array_sort_by(SortArray* arr, int (*compar)(const void*, const void*)) {
+    sort_region_by(arr, arr->data, arr->size, compar);
+    arr->sorted = 0;
+}
+
+/* ===================== 增量排序模块 ===================== */
+/* 尾部缓冲区的最小归并长度；未指定上限时随有序区按1/16增长，均摊后每个元素只搬运常数次 */
+#define SORT_TAIL_MIN 1024
+#define SORT_TAIL_RATIO 16
+
+static int sort_array_compare(const SortArray* arr, const void* a, const void* b) {
+    if (arr->type == SORT_STRING_POOL)
+        return string_pool_compare(arr->pool, a, b);
+    return sort_comparator(arr->type)(a, b);
+}
+
+static size_t sort_array_tail_limit(const SortArray* arr) {
+    if (arr->tail_limit) return arr->tail_limit;
+    size_t grow = arr->sorted / SORT_TAIL_RATIO;
+    return grow > SORT_TAIL_MIN ? grow : SORT_TAIL_MIN;
+}
+
+/*
+ * 排序尾部[sorted, size)后与有序区归并：有序区中不大于尾部首元素的前缀原地不动，
+ * 尾部复制到缓冲区后从右向左归并。相等元素有序区在前。
+ * 缓冲区分配失败时退回整体排序。
+ */
+static void sort_array_merge_tail(SortArray* arr) {
+    size_t es = arr->element_size;
+    char* data = arr->data;
+    size_t tail = arr->size - arr->sorted;
+    char* tail_base = data + arr->sorted * es;
+    sort_region(arr, tail_base, tail);
+
+    // 追加为主的输入：尾部整体不小于有序区末元素时无需搬运
+    if (sort_array_compare(arr, tail_base - es, tail_base) <= 0) return;
+
+    if (arr->merge_buffer.bytes < tail * es) {
+        void* buf = realloc(arr->merge_buffer.data, tail * es);
+        if (!buf) {
+            sort_region(arr, data, arr->size);
+            return;
+        }
+        arr->merge_buffer.data = buf;
+        arr->merge_buffer.bytes = tail * es;
+    }
+    char* buf = arr->merge_buffer.data;
+    memcpy(buf, tail_base, tail * es);
+
+    // 二分找到有序区中第一个大于尾部首元素的位置，之前的元素不参与归并
+    size_t lo = 0, hi = arr->sorted;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (sort_array_compare(arr, data + mid * es, buf) <= 0) lo = mid + 1;
+        else hi = mid;
+    }
+
+    size_t i = arr->sorted, j = tail, k = arr->size;
+    while (j > 0) {
+        if (i > lo && sort_array_compare(arr, buf + (j - 1) * es, data + (i - 1) * es) < 0) {
+            memcpy(data + --k * es, data + --i * es, es);
+        } else {
+            memcpy(data + --k * es, buf + --j * es, es);
+        }
+    }
+}
+
+/* 把尾部缓冲区并入有序区，之后整个数组有序；非增量模式下等同sort_array_sort */
+void sort_array_flush(SortArray* arr) {
+    if (!arr->incremental) {
+        sort_region(arr, arr->data, arr->size);
+        return;
+    }
+    if (arr->sorted == arr->size) return;
+    if (arr->sorted == 0) sort_region(arr, arr->data, arr->size);
+    else sort_array_merge_tail(arr);
+    arr->sorted = arr->size;
+}
+
+/*
+ * 开启（enable非0）或关闭增量模式。开启后插入只追加到尾部，尾部长度达到tail_limit
+ * （0表示max(1024, 有序区/16)）时排序并归并进有序区；排序、选择与sort_array_at
+ * 会先归并剩余尾部，因此不需要完整重排。直接读取data前应调用sort_array_flush
+ */
+void sort_array_set_incremental(SortArray* arr, int enable, size_t tail_limit) {
+    arr->incremental = enable != 0;
+    arr->tail_limit = tail_limit;
+    arr->sorted = 0;
+}
+
+/* 增量模式下的第i个元素（按顺序），必要时先归并尾部；越界返回NULL */
+const void* sort_array_at(SortArray* arr, size_t i) {
+    if (i >= arr->size) return NULL;
+    if (arr->incremental && arr->sorted != arr->size) sort_array_flush(arr);
+    return (const char*)arr->data + i * arr->element_size;
+}
+
+/* 插入后尾部过长时归并 */
+static void sort_array_after_insert(SortArray* arr) {
+    if (arr->incremental && arr->size - arr->sorted >= sort_array_tail_limit(arr))
+        sort_array_flush(arr);
+}
+
+/* 按数组选定的算法排序；增量模式下只需归并尾部 */
+void sort_array_sort(SortArray* arr) {
+    if (arr->incremental) sort_array_flush(arr);
+    else sort_region(arr, arr->data, arr->size);
+}
+
+#define SORT_RUN_SELECT(name, T, arr, k, partial)                      \
+    do {                                                               \
+        if (partial) sort_partial_##name((T*)(arr)->data, (arr)->size, (k)); \
+        else sort_select_##name((T*)(arr)->data, (arr)->size, (k));     \
+    } while (0)
+
+static int sort_select_pool(SortArray* arr, size_t k, int partial) {
+    StringPoolEntry* entries = arr->data;
+    SortPoolRef* refs = malloc(arr->size * sizeof(SortPoolRef));
+    if (!refs) return -1;
+    for (size_t i = 0; i < arr->size; i++) {
+        refs[i].str = string_pool_str(arr->pool, &entries[i]);
+        refs[i].entry = entries[i];
+    }
+    if (partial) sort_partial_pool_ref(refs, arr->size, k);
+    else sort_select_pool_ref(refs, arr->size, k);
+    for (size_t i = 0; i < arr->size; i++)
+        entries[i] = refs[i].entry;
+    free(refs);
+    return 0;
+}
+
+static int sort_select_run(SortArray* arr, size_t k, int partial) {
+    switch(arr->type) {
+        case SORT_INT: SORT_RUN_SELECT(int, int, arr, k, partial); break;
+        case SORT_FLOAT: SORT_RUN_SELECT(float, float, arr, k, partial); break;
+        case SORT_DOUBLE: SORT_RUN_SELECT(double, double, arr, k, partial); break;
+        case SORT_STRING: SORT_RUN_SELECT(string, char*, arr, k, partial); break;
+        case SORT_STRUCT: SORT_RUN_SELECT(struct, TestData, arr, k, partial); break;
+        case SORT_STRING_POOL: return sort_select_pool(arr, k, partial);
+        default: return -1;
+    }
+    return 0;
+}
+
+/*
+ * 部分排序：最小的k个元素按升序放在前k位，其余元素顺序不定。
+ * k远小于元素个数时用有界堆，否则先内省选择再排序前k个；k不小于元素个数时完整排序，
+ * 增量模式下只归并尾部。
+ * 成功返回0，失败返回-1（数据保持不变）
+ */
+int sort_array_partial(SortArray* arr, size_t k) {
+    if (k == 0 || arr->size < 2) return 0;
+    if (k >= arr->size || arr->incremental) {
+        sort_array_sort(arr);
+        return 0;
+    }
+    return sort_select_run(arr, k, 1);
+}
+
+/*
+ * 选择（nth_element）：第k个（从0起）元素放到完整排序后的位置，
+ * 前面的元素都不大于它，后面的都不小于它，两侧内部顺序不定。平均O(n)。
+ * k越界或失败时返回-1
+ */
+int sort_array_select(SortArray* arr, size_t k) {
+    if (k >= arr->size) return -1;
+    // 增量模式下归并尾部即整体有序
+    if (arr->incremental) {
+        sort_array_flush(arr);
+        return 0;
+    }
+    return sort_select_run(arr, k, 0);
+}
+
 void sort_array_free(SortArray* arr) {
+    if (arr->pool) {
+        string_pool_free(arr->pool);
+        free(arr->pool);
+    }
+    stable_sort_buffer_free(&arr->merge_buffer);
     free(arr->data);
     free(arr);
 }
 
+/* SORT_STRING与SORT_STRING_POOL的第i个字符串 */
+const char* sort_array_string_at(const SortArray* arr, size_t i) {
+    if (arr->type == SORT_STRING_POOL)
+        return string_pool_str(arr->pool, &((const StringPoolEntry*)arr->data)[i]);
+    return ((char* const*)arr->data)[i];
+}
+
+/* 保证至少能容纳capacity个元素，已有元素不变；成功返回0，内存不足返回-1 */
+int sort_array_reserve(SortArray* arr, size_t capacity) {
+    if (capacity <= arr->capacity) return 0;
+    if (!arr->element_size || capacity > SIZE_MAX / arr->element_size) return -1;
+    void* new_data = realloc(arr->data, capacity * arr->element_size);
+    if (!new_data) return -1;
+    arr->data = new_data;
+    arr->capacity = capacity;
+    return 0;
+}
+
+/* 容量不足时按倍增扩到至少need个 */
+static int sort_array_grow(SortArray* arr, size_t need) {
+    if (need <= arr->capacity) return 0;
+    size_t new_cap = arr->capacity ? arr->capacity * 2 : 4;
+    if (new_cap < need) new_cap = need;
+    return sort_array_reserve(arr, new_cap);
+}
+
+/* SORT_STRING_POOL的element与SORT_STRING相同，为指向char*的指针，字符串字节会被复制进池 */
 int sort_array_insert(SortArray* arr, const void* element) {
-    size_t element_size;
-    switch(arr->type) {
-        case SORT_INT: element_size = sizeof(int); break;
-        case SORT_FLOAT: element_size = sizeof(float); break;
-        case SORT_DOUBLE: element_size = sizeof(double); break;
-        case SORT_STRING: element_size = sizeof(char*); break;
-        case SORT_STRUCT: element_size = sizeof(TestData); break;
-        default: return -1;
-    }
+    size_t element_size = arr->element_size;
+    if (!element_size) return -1;
 
-    if (arr->size >= arr->capacity) {
-        size_t new_cap = arr->capacity ? arr->capacity * 2 : 4;
-        void* new_data = realloc(arr->data, new_cap * element_size);
-        if (!new_data) return -1;
-        arr->data = new_data;
-        arr->capacity = new_cap;
+    StringPoolEntry entry;
+    if (arr->type == SORT_STRING_POOL) {
+        const char* str = *(const char* const*)element;
+        if (!arr->pool || string_pool_add(arr->pool, str, strlen(str), &entry) != 0)
+            return -1;
+        element = &entry;
     }
+
+    if (arr->size >= arr->capacity && sort_array_grow(arr, arr->size + 1) != 0)
+        return -1;
     memcpy((char*)arr->data + arr->size * element_size, element, element_size);
     arr->size++;
+    sort_array_after_insert(arr);
+    return 0;
+}
+
+/*
+ * 批量追加n个连续元素，布局与sort_array_insert的element相同（SORT_STRING_POOL为char*数组）。
+ * 只扩容一次并整块复制。成功返回0；失败返回-1，已有元素不变（字符串池可能已追加部分字节）
+ */
+int sort_array_insert_bulk(SortArray* arr, const void* elements, size_t n) {
+    if (!arr->element_size) return -1;
+    if (n == 0) return 0;
+    if (n > SIZE_MAX - arr->size || sort_array_grow(arr, arr->size + n) != 0) return -1;
+
+    if (arr->type == SORT_STRING_POOL) {
+        const char* const* strs = elements;
+        StringPoolEntry* entries = (StringPoolEntry*)arr->data + arr->size;
+        for (size_t i = 0; i < n; i++) {
+            if (!arr->pool || string_pool_add(arr->pool, strs[i], strlen(strs[i]), &entries[i]) != 0)
+                return -1;
+        }
+    } else {
+        memcpy((char*)arr->data + arr->size * arr->element_size, elements, n * arr->element_size);
+    }
+    arr->size += n;
+    sort_array_after_insert(arr);
+    return 0;
+}
+
+/*
+ * 接管调用方用malloc分配的buffer（n个元素）作为数组数据，不复制；原有元素被释放。
+ * 之后buffer归数组所有，由sort_array_free释放。字符串池的条目依赖池内字节，不支持接管，返回-1
+ */
+int sort_array_adopt(SortArray* arr, void* buffer, size_t n) {
+    if (!arr->element_size || arr->type == SORT_STRING_POOL) return -1;
+    if (!buffer && n) return -1;
+    free(arr->data);
+    arr->data = buffer;
+    arr->size = n;
+    arr->capacity = n;
+    arr->sorted = 0;
     return 0;
 }
 
@@ -132,6 +770,92 @@ void init_test_data();
 void print_test_data();
 
 /* ===================== 测试模块 ===================== */
+/* 全类型测试各项的分阶段计时：每次重复分别记录重置、哈希与排序，
+ * 以--perf启动且计数器可用时同时累计硬件计数器 */
+enum { PHASE_RESET, PHASE_HASH, PHASE_SORT, PHASE_COUNT };
+
+typedef struct {
+    TimerPhase time[PHASE_COUNT];
+    PerfPhase counters[PHASE_COUNT];
+} PhaseTimes;
+
+/* 阶段边界：时间戳与计数器快照 */
+typedef struct {
+    uint64_t ticks;
+    PerfSnapshot counters;
+} PhaseMark;
+
+static PerfCounters perf_counters; /* 零初始化即未启用 */
+
+static void phase_mark(PhaseMark* mark) {
+    mark->ticks = timer_now();
+    perf_counters_read(&perf_counters, &mark->counters);
+}
+
+static void phase_times_init(PhaseTimes* times) {
+    static const char* const names[PHASE_COUNT] = { "重置", "哈希", "排序" };
+    for(int i = 0; i < PHASE_COUNT; i++) {
+        timer_phase_init(&times->time[i], names[i]);
+        perf_phase_clear(&times->counters[i]);
+    }
+}
+
+static void phase_times_clear(PhaseTimes* times) {
+    for(int i = 0; i < PHASE_COUNT; i++) {
+        timer_phase_clear(&times->time[i]);
+        perf_phase_clear(&times->counters[i]);
+    }
+}
+
+static void phase_times_free(PhaseTimes* times) {
+    for(int i = 0; i < PHASE_COUNT; i++)
+        timer_phase_free(&times->time[i]);
+}
+
+static void phase_times_add(PhaseTimes* times, int phase, const PhaseMark* begin, const PhaseMark* end) {
+    timer_phase_add(&times->time[phase], timer_seconds(end->ticks - begin->ticks));
+    perf_phase_add(&times->counters[phase], &begin->counters, &end->counters);
+}
+
+/* 某阶段平均每次的计数器值；计数器不可用时返回-1 */
+static double phase_counter_mean(const PhaseTimes* times, int phase, PerfCounterId id) {
+    const PerfPhase* counters = &times->counters[phase];
+    if(!perf_counter_available(&perf_counters, id) || counters->samples == 0) return -1;
+    return (double)counters->total[id] / counters->samples;
+}
+
+/* 打印总用时与各阶段分布，未采样的阶段不输出；计数器不可用时显示n/a */
+static void phase_times_print(const char* label, PhaseTimes* times) {
+    TimerStats stats[PHASE_COUNT];
+    double total = 0;
+    for(int i = 0; i < PHASE_COUNT; i++) {
+        timer_phase_stats(&times->time[i], &stats[i]);
+        total += stats[i].total;
+    }
+    printf("\n%s用时: %f 秒\n", label, total);
+    for(int i = 0; i < PHASE_COUNT; i++) {
+        if(stats[i].count == 0) continue;
+        printf("  %s阶段用时(%zu次): 最小 %.6f 中位 %.6f p99 %.6f 最大 %.6f 秒\n",
+               times->time[i].name, stats[i].count, stats[i].min, stats[i].median,
+               stats[i].p99, stats[i].max);
+        if(!perf_counters.enabled) continue;
+
+        printf("  %s阶段计数器(平均每次):", times->time[i].name);
+        for(int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            double mean = phase_counter_mean(times, i, (PerfCounterId)c);
+            if(mean < 0)
+                printf(" %s=n/a", perf_counter_name((PerfCounterId)c));
+            else
+                printf(" %s=%.0f", perf_counter_name((PerfCounterId)c), mean);
+        }
+        double cycles = phase_counter_mean(times, i, PERF_CYCLES);
+        double instructions = phase_counter_mean(times, i, PERF_INSTRUCTIONS);
+        if(cycles > 0 && instructions >= 0)
+            printf(" IPC=%.2f", instructions / cycles);
+        printf("\n");
+    }
+}
+
 static void test_sort() {
     int type;
     printf("请选择排序类型:\n");
@@ -139,24 +863,34 @@ static void test_sort() {
     printf("2. 字符串排序\n");
     printf("3. 结构体排序\n");
     printf("4. 全类型测试数据排序\n");
+    printf("5. 外部排序(文件)\n");
     scanf("%d", &type);
     getchar(); // 消除换行符
 
+    // 1-3为交互输入：先读个数再逐项提示，且stdin已被上面的scanf缓冲，
+    // 不能交给按fd读到EOF的input_buffer_open；大批量输入使用--sort模式
     switch(type) {
         case 1: {
             SortArray* arr = sort_array_create(SORT_INT);
             printf("请输入要排序的整数个数: ");
-            int n;
+            int n = 0;
             scanf("%d", &n);
+            if(n < 0) n = 0;
             printf("请输入%d个整数:\n", n);
             
-            for(int i = 0; i < n; i++) {
-                int num;
-                scanf("%d", &num);
-                sort_array_insert(arr, &num);
+            // 读入同一块数组后整体接管，不逐个插入
+            int* nums = malloc((n ? (size_t)n : 1) * sizeof(int));
+            if(!nums) {
+                printf("内存不足\n");
+                sort_array_free(arr);
+                break;
             }
+            int read_count = 0;
+            while(read_count < n && scanf("%d", &nums[read_count]) == 1)
+                read_count++;
+            sort_array_adopt(arr, nums, read_count);
             
-            sort_bubble(arr->data, arr->size, sizeof(int), compare_int);
+            sort_array_sort(arr);
             
             printf("整数排序结果: ");
             for(int i = 0; i < arr->size; i++)
@@ -184,7 +918,7 @@ static void test_sort() {
                 sort_array_insert(arr, &strings[i]);
             }
             
-            sort_bubble(arr->data, arr->size, sizeof(char*), compare_string);
+            sort_array_sort(arr);
             
             printf("字符串排序结果: ");
             for(int i = 0; i < arr->size; i++)
@@ -224,7 +958,7 @@ static void test_sort() {
                 sort_array_insert(arr, &data[i]);
             }
             
-            sort_bubble(arr->data, arr->size, sizeof(TestData), compare_struct);
+            sort_array_sort(arr);
             
             printf("结构体排序结果:\n");
             for(int i = 0; i < arr->size; i++) {
@@ -237,35 +971,41 @@ static void test_sort() {
             break;
         }
         case 4: {
-            clock_t start_time, end_time;
-            double cpu_time_used;
+            int count = (int)test_data_count; // 运行期元素个数，默认TEST_COUNT
+            if(count <= 0 || (size_t)count != test_data_count) {
+                printf("测试数据为空或超出范围\n");
+                break;
+            }
+            PhaseTimes times;
+            PhaseMark m0, m1, m2, m3;
+            phase_times_init(&times);
             
             // 整数排序测试
             SortArray* arr_int = sort_array_create(SORT_INT);
-            for(int i = 0; i < TEST_COUNT; i++)
-                sort_array_insert(arr_int, &int_data[i]);
+            sort_array_set_algorithm(arr_int, SORT_ALGO_RADIX);
+            sort_array_insert_bulk(arr_int, int_data, count);
             
             printf("\n=== 整数排序测试 ===\n");
-            printf("排序前(总计%d个):\n", TEST_COUNT);
+            printf("排序前(总计%d个):\n", count);
             
             // 输出前100个数据
-            for(int i = 0; i < 100 && i < TEST_COUNT; i++) {
+            for(int i = 0; i < 100 && i < count; i++) {
                 printf("%d ", int_data[i]);
                 if((i+1) % 10 == 0) printf("\n");
             }
             
             // 如果数据超过200个，直接跳到后100个
-            if (TEST_COUNT > 200) {
-                printf("\n... 省略%d个数据 ...\n\n", TEST_COUNT - 200);
+            if (count > 200) {
+                printf("\n... 省略%d个数据 ...\n\n", count - 200);
                 
                 // 输出后100个数据
-                for(int i = TEST_COUNT - 100; i < TEST_COUNT; i++) {
+                for(int i = count - 100; i < count; i++) {
                     printf("%d ", int_data[i]);
                     if((i+1) % 10 == 0) printf("\n");
                 }
-            } else if (TEST_COUNT > 100) {
+            } else if (count > 100) {
                 // 如果数据在100-200之间，输出剩余数据
-                for(int i = 100; i < TEST_COUNT; i++) {
+                for(int i = 100; i < count; i++) {
                     printf("%d ", int_data[i]);
                     if((i+1) % 10 == 0) printf("\n");
                 }
@@ -273,51 +1013,54 @@ static void test_sort() {
             printf("\n");
             
             // 重复排序多次以获得更准确的时间测量
-            start_time = clock();
+            phase_times_clear(&times);
             for(int repeat = 0; repeat < 10; repeat++) {  // 减少重复次数，因为样本数量已增加
-                // 每次排序前重置数据
-                for(int i = 0; i < TEST_COUNT; i++)
+                // 每次排序前重置数据，重置与排序分别计时
+                phase_mark(&m0);
+                for(int i = 0; i < count; i++)
                     ((int*)arr_int->data)[i] = int_data[i];
-                sort_bubble(arr_int->data, arr_int->size, sizeof(int), compare_int);
+                phase_mark(&m1);
+                sort_array_sort(arr_int);
+                phase_mark(&m2);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_SORT, &m1, &m2);
             }
-            end_time = clock();
-            cpu_time_used = ((double) (end_time - start_time)) / CLOCKS_PER_SEC;
             
-            printf("排序后(前%d个):\n", TEST_COUNT < 100 ? TEST_COUNT : 100);
-            for(int i = 0; i < TEST_COUNT && i < 100; i++) {
+            printf("排序后(前%d个):\n", count < 100 ? count : 100);
+            for(int i = 0; i < count && i < 100; i++) {
                 printf("%d ", ((int*)arr_int->data)[i]);
                 if((i+1) % 10 == 0) printf("\n");
             }
-            printf("\n整数排序用时: %f 秒\n", cpu_time_used);
+            phase_times_print("整数排序", &times);
             
             sort_array_free(arr_int);
             
             // 双精度浮点数排序测试
             SortArray* arr_double = sort_array_create(SORT_DOUBLE);
-            for(int i = 0; i < TEST_COUNT; i++)
-                sort_array_insert(arr_double, &double_data[i]);
+            sort_array_set_algorithm(arr_double, SORT_ALGO_RADIX);
+            sort_array_insert_bulk(arr_double, double_data, count);
             
             printf("\n=== 双精度浮点数排序测试 ===\n");
-            printf("排序前(总计%d个):\n", TEST_COUNT);
+            printf("排序前(总计%d个):\n", count);
             
             // 输出前100个数据
-            for(int i = 0; i < 100 && i < TEST_COUNT; i++) {
+            for(int i = 0; i < 100 && i < count; i++) {
                 printf("%.3e ", double_data[i]);
                 if((i+1) % 5 == 0) printf("\n");
             }
             
             // 如果数据超过200个，直接跳到后100个
-            if (TEST_COUNT > 200) {
-                printf("\n... 省略%d个数据 ...\n\n", TEST_COUNT - 200);
+            if (count > 200) {
+                printf("\n... 省略%d个数据 ...\n\n", count - 200);
                 
                 // 输出后100个数据
-                for(int i = TEST_COUNT - 100; i < TEST_COUNT; i++) {
+                for(int i = count - 100; i < count; i++) {
                     printf("%.3e ", double_data[i]);
                     if((i+1) % 5 == 0) printf("\n");
                 }
-            } else if (TEST_COUNT > 100) {
+            } else if (count > 100) {
                 // 如果数据在100-200之间，输出剩余数据
-                for(int i = 100; i < TEST_COUNT; i++) {
+                for(int i = 100; i < count; i++) {
                     printf("%.3e ", double_data[i]);
                     if((i+1) % 5 == 0) printf("\n");
                 }
@@ -325,53 +1068,58 @@ static void test_sort() {
             printf("\n");
             
             // 重复排序多次以获得更准确的时间测量
-            start_time = clock();
+            phase_times_clear(&times);
             for(int repeat = 0; repeat < 10; repeat++) {  // 减少重复次数，因为样本数量已增加
-                // 每次排序前重置数据
-                for(int i = 0; i < TEST_COUNT; i++)
+                // 每次排序前重置数据，重置与排序分别计时
+                phase_mark(&m0);
+                for(int i = 0; i < count; i++)
                     ((double*)arr_double->data)[i] = double_data[i];
-                sort_bubble(arr_double->data, arr_double->size, sizeof(double), compare_double);
+                phase_mark(&m1);
+                sort_array_sort(arr_double);
+                phase_mark(&m2);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_SORT, &m1, &m2);
             }
-            end_time = clock();
-            cpu_time_used = ((double) (end_time - start_time)) / CLOCKS_PER_SEC;
             
-            printf("排序后(前%d个):\n", TEST_COUNT < 100 ? TEST_COUNT : 100);
-            for(int i = 0; i < TEST_COUNT && i < 100; i++) {
+            printf("排序后(前%d个):\n", count < 100 ? count : 100);
+            for(int i = 0; i < count && i < 100; i++) {
                 printf("%.3e ", ((double*)arr_double->data)[i]);
                 if((i+1) % 5 == 0) printf("\n");
             }
-            printf("\n双精度浮点数排序用时: %f 秒\n", cpu_time_used);
+            phase_times_print("双精度浮点数排序", &times);
             
             sort_array_free(arr_double);
             
             // 字符排序测试
             SortArray* arr_char = sort_array_create(SORT_INT); // 用INT类型存储char
-            for(int i = 0; i < TEST_COUNT; i++) {
+            sort_array_set_algorithm(arr_char, SORT_ALGO_RADIX); // 高位全同，只需一趟
+            sort_array_reserve(arr_char, count);
+            for(int i = 0; i < count; i++) {
                 int char_val = (int)char_data[i];
                 sort_array_insert(arr_char, &char_val);
             }
             
             printf("\n=== 字符排序测试 ===\n");
-            printf("排序前(总计%d个):\n", TEST_COUNT);
+            printf("排序前(总计%d个):\n", count);
             
             // 输出前100个数据
-            for(int i = 0; i < 100 && i < TEST_COUNT; i++) {
+            for(int i = 0; i < 100 && i < count; i++) {
                 printf("'%c' ", char_data[i]);
                 if((i+1) % 10 == 0) printf("\n");
             }
             
             // 如果数据超过200个，直接跳到后100个
-            if (TEST_COUNT > 200) {
-                printf("\n... 省略%d个数据 ...\n\n", TEST_COUNT - 200);
+            if (count > 200) {
+                printf("\n... 省略%d个数据 ...\n\n", count - 200);
                 
                 // 输出后100个数据
-                for(int i = TEST_COUNT - 100; i < TEST_COUNT; i++) {
+                for(int i = count - 100; i < count; i++) {
                     printf("'%c' ", char_data[i]);
                     if((i+1) % 10 == 0) printf("\n");
                 }
-            } else if (TEST_COUNT > 100) {
+            } else if (count > 100) {
                 // 如果数据在100-200之间，输出剩余数据
-                for(int i = 100; i < TEST_COUNT; i++) {
+                for(int i = 100; i < count; i++) {
                     printf("'%c' ", char_data[i]);
                     if((i+1) % 10 == 0) printf("\n");
                 }
@@ -379,47 +1127,52 @@ static void test_sort() {
             printf("\n");
             
             // 重复排序多次以获得更准确的时间测量
-            start_time = clock();
+            phase_times_clear(&times);
             for(int repeat = 0; repeat < 10; repeat++) {  // 减少重复次数，因为样本数量已增加
-                // 每次排序前重置数据
-                for(int i = 0; i < TEST_COUNT; i++) {
+                // 每次排序前重置数据，重置与排序分别计时
+                phase_mark(&m0);
+                for(int i = 0; i < count; i++) {
                     int char_val = (int)char_data[i];
                     ((int*)arr_char->data)[i] = char_val;
                 }
-                sort_bubble(arr_char->data, arr_char->size, sizeof(int), compare_int);
+                phase_mark(&m1);
+                sort_array_sort(arr_char);
+                phase_mark(&m2);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_SORT, &m1, &m2);
             }
-            end_time = clock();
-            cpu_time_used = ((double) (end_time - start_time)) / CLOCKS_PER_SEC;
             
-            printf("排序后(前%d个):\n", TEST_COUNT < 100 ? TEST_COUNT : 100);
-            for(int i = 0; i < TEST_COUNT && i < 100; i++) {
+            printf("排序后(前%d个):\n", count < 100 ? count : 100);
+            for(int i = 0; i < count && i < 100; i++) {
                 printf("'%c' ", (char)((int*)arr_char->data)[i]);
                 if((i+1) % 10 == 0) printf("\n");
             }
-            printf("\n字符排序用时: %f 秒\n", cpu_time_used);
+            phase_times_print("字符排序", &times);
             
             sort_array_free(arr_char);
             
-            // 字符串排序测试
-            SortArray* arr_str = sort_array_create(SORT_STRING);
-            char** str_ptrs = malloc(TEST_COUNT * sizeof(char*));
-            for(int i = 0; i < TEST_COUNT; i++) {
-                str_ptrs[i] = strdup(string_data[i]);
-                sort_array_insert(arr_str, &str_ptrs[i]);
+            // 字符串排序测试（字符串池：所有字节一次装入，重置只需恢复条目顺序）
+            SortArray* arr_str = sort_array_create(SORT_STRING_POOL);
+            sort_array_reserve(arr_str, count);
+            for(int i = 0; i < count; i++) {
+                const char* str = string_data[i];
+                sort_array_insert(arr_str, &str);
             }
+            StringPoolEntry* str_entries = malloc(count * sizeof(StringPoolEntry));
+            memcpy(str_entries, arr_str->data, count * sizeof(StringPoolEntry));
             
             printf("\n=== 字符串排序测试 ===\n");
-            printf("排序前(总计%d个):\n", TEST_COUNT);
-            for(int i = 0; i < TEST_COUNT; i++) {
-                if (TEST_COUNT > 200) {
+            printf("排序前(总计%d个):\n", count);
+            for(int i = 0; i < count; i++) {
+                if (count > 200) {
                     if (i < 100) {
                         printf("\"%s\" ", string_data[i]);
                         if((i+1) % 3 == 0) printf("\n");
-                    } else if (i >= TEST_COUNT - 100) {
+                    } else if (i >= count - 100) {
                         printf("\"%s\" ", string_data[i]);
                         if((i+1) % 3 == 0) printf("\n");
                     } else if (i == 100) {
-                        printf("\n... 省略%d个数据 ...\n\n", TEST_COUNT - 200);
+                        printf("\n... 省略%d个数据 ...\n\n", count - 200);
                     }
                 } else {
                     printf("\"%s\" ", string_data[i]);
@@ -429,45 +1182,42 @@ static void test_sort() {
             printf("\n");
             
             // 重复排序多次以获得更准确的时间测量
-            start_time = clock();
+            phase_times_clear(&times);
             for(int repeat = 0; repeat < 5; repeat++) { // 字符串操作较慢，且样本数量已增加
-                // 每次排序前重置数据
-                for(int i = 0; i < TEST_COUNT; i++) {
-                    // 释放旧字符串
-                    free(*(char**)((char*)arr_str->data + i * sizeof(char*)));
-                    // 分配新字符串
-                    char* new_str = strdup(string_data[i]);
-                    *(char**)((char*)arr_str->data + i * sizeof(char*)) = new_str;
-                }
-                sort_bubble(arr_str->data, arr_str->size, sizeof(char*), compare_string);
+                // 每次排序前重置数据，重置与排序分别计时
+                phase_mark(&m0);
+                memcpy(arr_str->data, str_entries, count * sizeof(StringPoolEntry));
+                phase_mark(&m1);
+                sort_array_sort(arr_str);
+                phase_mark(&m2);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_SORT, &m1, &m2);
             }
-            end_time = clock();
-            cpu_time_used = ((double) (end_time - start_time)) / CLOCKS_PER_SEC;
             
-            printf("排序后(前%d个):\n", TEST_COUNT < 100 ? TEST_COUNT : 100);
-            for(int i = 0; i < TEST_COUNT && i < 100; i++) {
-                printf("\"%s\" ", *(char**)((char*)arr_str->data + i * sizeof(char*)));
+            printf("排序后(前%d个):\n", count < 100 ? count : 100);
+            for(int i = 0; i < count && i < 100; i++) {
+                printf("\"%s\" ", sort_array_string_at(arr_str, i));
                 if((i+1) % 3 == 0) printf("\n");
             }
-            printf("\n字符串排序用时: %f 秒\n", cpu_time_used);
+            phase_times_print("字符串排序", &times);
             
-            for(int i = 0; i < TEST_COUNT; i++)
-                free(str_ptrs[i]);
-            free(str_ptrs);
+            free(str_entries);
             sort_array_free(arr_str);
             
             // 结构体排序测试
             SortArray* arr_struct = sort_array_create(SORT_STRUCT);
-            MD5_CTX ctx;
+            sort_array_set_algorithm(arr_struct, SORT_ALGO_PARALLEL);
             uint8_t digest[MD5_DIGEST_SIZE];
-            TestData* struct_copy = malloc(TEST_COUNT * sizeof(TestData));
+            TestData* struct_copy = malloc(count * sizeof(TestData));
+            MD5_CACHE digest_cache; // 名字只有FRUIT_TYPES种，摘要走缓存
+            md5_cache_init(&digest_cache, FRUIT_TYPES * 2);
             
             printf("\n=== 结构体排序测试 ===\n");
-            printf("排序前(总计%d个):\n", TEST_COUNT);
-            for(int i = 0; i < TEST_COUNT; i++) {
-                if (TEST_COUNT > 200 && i == 100) {
-                    printf("\n... 省略%d个数据 ...\n\n", TEST_COUNT - 200);
-                    i = TEST_COUNT - 100;
+            printf("排序前(总计%d个):\n", count);
+            for(int i = 0; i < count; i++) {
+                if (count > 200 && i == 100) {
+                    printf("\n... 省略%d个数据 ...\n\n", count - 200);
+                    i = count - 100;
                 }
                 printf("%s (原始hash: 0x%08X) ", struct_data[i].name, struct_data[i].hash);
                 if((i+1) % 3 == 0) printf("\n");
@@ -475,7 +1225,7 @@ static void test_sort() {
             printf("\n");
             
             // 复制并计算新的MD5哈希
-            for(int i = 0; i < TEST_COUNT; i++) {
+            for(int i = 0; i < count; i++) {
 #ifdef __STDC_LIB_EXT1__
                 strncpy_s(struct_copy[i].name, sizeof(struct_copy[i].name), struct_data[i].name, sizeof(struct_copy[i].name) - 1);
 #else
@@ -483,18 +1233,18 @@ static void test_sort() {
                 struct_copy[i].name[sizeof(struct_copy[i].name) - 1] = '\0';
 #endif
                 // 仅基于结构体的name字段计算哈希值
-                md5_init(&ctx);
-                md5_update(&ctx, (const uint8_t*)struct_copy[i].name, strlen(struct_copy[i].name));
-                md5_final(&ctx, digest);
+                md5_cached(&digest_cache, (const uint8_t*)struct_copy[i].name,
+                           strlen(struct_copy[i].name), digest);
                 struct_copy[i].hash = *(uint32_t*)digest;
-                sort_array_insert(arr_struct, &struct_copy[i]);
             }
+            sort_array_insert_bulk(arr_struct, struct_copy, count);
             
             // 重复排序多次以获得更准确的时间测量
-            start_time = clock();
+            phase_times_clear(&times);
             for(int repeat = 0; repeat < 5; repeat++) { // 结构体操作较慢，且样本数量已增加
-                // 每次排序前重置数据
-                for(int i = 0; i < TEST_COUNT; i++) {
+                // 每次排序前重置数据并重新计算哈希，三个阶段分别计时
+                phase_mark(&m0);
+                for(int i = 0; i < count; i++) {
                     TestData* target = &((TestData*)arr_struct->data)[i];
 #ifdef __STDC_LIB_EXT1__
                     strncpy_s(target->name, sizeof(target->name), struct_data[i].name, sizeof(target->name) - 1);
@@ -502,27 +1252,78 @@ static void test_sort() {
                     strncpy(target->name, struct_data[i].name, sizeof(target->name) - 1);
                     target->name[sizeof(target->name) - 1] = '\0';
 #endif
+                }
+                phase_mark(&m1);
+                for(int i = 0; i < count; i++) {
+                    TestData* target = &((TestData*)arr_struct->data)[i];
                     // 仅基于结构体的name字段计算哈希值
-                    md5_init(&ctx);
-                    md5_update(&ctx, (const uint8_t*)target->name, strlen(target->name));
-                    md5_final(&ctx, digest);
+                    md5_cached(&digest_cache, (const uint8_t*)target->name,
+                               strlen(target->name), digest);
                     target->hash = *(uint32_t*)digest;
                 }
-                sort_bubble(arr_struct->data, arr_struct->size, sizeof(TestData), compare_struct);
+                phase_mark(&m2);
+                sort_array_sort(arr_struct);
+                phase_mark(&m3);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_HASH, &m1, &m2);
+                phase_times_add(&times, PHASE_SORT, &m2, &m3);
             }
-            end_time = clock();
-            cpu_time_used = ((double) (end_time - start_time)) / CLOCKS_PER_SEC;
             
-            printf("排序后(全部%d个):\n", TEST_COUNT);
-            for(int i = 0; i < TEST_COUNT; i++) {
+            printf("排序后(全部%d个):\n", count);
+            // 全部记录经缓冲区格式化后整块写出，不逐个调用printf
+            OutputBuffer out;
+            output_buffer_init(&out, stdout, 0);
+            for(int i = 0; i < count; i++) {
                 const TestData* s = &((TestData*)arr_struct->data)[i];
-                printf("%s (MD5 hash: 0x%08X) ", s->name, s->hash);
-                if((i+1) % 3 == 0) printf("\n");
+                output_str(&out, s->name);
+                output_write(&out, " (MD5 hash: 0x", 14);
+                output_hex32(&out, s->hash);
+                output_write(&out, ") ", 2);
+                if((i+1) % 3 == 0) output_char(&out, '\n');
             }
-            printf("\n结构体排序用时: %f 秒\n", cpu_time_used);
+            output_buffer_close(&out);
+            phase_times_print("结构体排序", &times);
+            printf("MD5摘要缓存: 命中%zu次, 未命中%zu次\n", digest_cache.hits, digest_cache.misses);
             
             free(struct_copy);
+            md5_cache_free(&digest_cache);
             sort_array_free(arr_struct);
+            phase_times_free(&times);
+            break;
+        }
+        case 5: {
+            int kind;
+            char in_path[256], out_path[256];
+            size_t budget_mb;
+            printf("请选择文件数据类型(1.整数 2.双精度 3.字符串行 4.结构体): ");
+            scanf("%d", &kind);
+            printf("请输入源文件路径: ");
+            scanf("%255s", in_path);
+            printf("请输入结果文件路径: ");
+            scanf("%255s", out_path);
+            printf("请输入内存预算(MB): ");
+            scanf("%zu", &budget_mb);
+
+            // 定长记录文件为元素的原始二进制表示，字符串文件为每行一个
+            static const SortType kinds[] = { SORT_INT, SORT_DOUBLE, SORT_STRING, SORT_STRUCT };
+            if(kind < 1 || kind > 4) {
+                printf("无效的选择\n");
+                break;
+            }
+            SortType elem_type = kinds[kind - 1];
+            ExternalSortConfig config = { budget_mb << 20, NULL, sort_bucket_kernel(elem_type) };
+
+            uint64_t start_time = timer_now();
+            int rc = elem_type == SORT_STRING
+                ? external_sort_lines(in_path, out_path, compare_string, &config)
+                : external_sort_records(in_path, out_path, sort_element_size(elem_type),
+                                        sort_comparator(elem_type), &config);
+            double elapsed = timer_seconds(timer_now() - start_time);
+
+            if(rc != 0)
+                printf("外部排序失败\n");
+            else
+                printf("外部排序完成: %s, 用时: %f 秒\n", out_path, elapsed);
             break;
         }
         default:
@@ -530,8 +1331,552 @@ static void test_sort() {
     }
 }
 
+/* ===================== 基准测试模块 ===================== */
+/*
+ * 非交互基准测试：bubblesort --bench [选项]
+ *   --type     int,float,double,string,pool,struct 逗号分隔（默认int）
+ *   --n        元素个数（默认TEST_COUNT）
+ *   --algo     intro,heap,insertion,bubble,radix,parallel,multikey,packed,stable 逗号分隔（默认intro）
+ *   --repeats  每个用例的重复次数（默认10）
+ *   --threads  并行排序线程数（默认0，即全部在线CPU）
+ *   --dist     random,sorted,reverse,nearly,organ,few,zipf,equal之一（默认random）
+ *   --swaps    nearly的交换次数；--unique few/zipf的不同取值个数；--zipf Zipf指数
+ *   --seed     随机种子（默认20231115），第i个元素只由种子、类型与i决定
+ *   --format   json或csv（默认json）
+ *   --perf     附带排序阶段平均每次的硬件计数器（不可用的计数器为null或空）
+ * 每个类型与算法的组合为一个用例，输出一条记录；过程中不打印数据。
+ * 每次重复前从原始数据恢复数组，恢复与排序分别计时，统计只针对排序阶段。
+ */
+#define BENCH_MAX_LIST 16
+#define BENCH_DEFAULT_SEED 20231115
+#define BENCH_MD5_BATCH 1024
+
+typedef struct {
+    const char* name;
+    int value;
+} BenchName;
+
+static const BenchName bench_types[] = {
+    { "int", SORT_INT }, { "float", SORT_FLOAT }, { "double", SORT_DOUBLE },
+    { "string", SORT_STRING }, { "pool", SORT_STRING_POOL }, { "struct", SORT_STRUCT }
+};
+
+static const BenchName bench_algorithms[] = {
+    { "intro", SORT_ALGO_INTRO }, { "heap", SORT_ALGO_HEAP },
+    { "insertion", SORT_ALGO_INSERTION }, { "bubble", SORT_ALGO_BUBBLE },
+    { "radix", SORT_ALGO_RADIX }, { "parallel", SORT_ALGO_PARALLEL },
+    { "multikey", SORT_ALGO_MULTIKEY }, { "packed", SORT_ALGO_PACKED },
+    { "stable", SORT_ALGO_STABLE }
+};
+
+
+#define BENCH_COUNT(table) (sizeof(table) / sizeof((table)[0]))
+
+typedef struct {
+    int types[BENCH_MAX_LIST];
+    int type_count;
+    int algorithms[BENCH_MAX_LIST];
+    int algorithm_count;
+    size_t n;
+    int repeats;
+    int threads;
+    TestDataShape shape;
+    int csv;
+    int perf;
+} BenchOptions;
+
+/* 一个类型的输入：source保存原始顺序，每次重复前复制到arr */
+typedef struct {
+    SortArray* arr;
+    void* source;
+    char* text;          /* 字符串与结构体名字的字节 */
+    size_t bytes;        /* 被排序元素的总字节数 */
+} BenchInput;
+
+static int bench_lookup(const BenchName* table, size_t count, const char* name) {
+    for (size_t i = 0; i < count; i++)
+        if (strcmp(table[i].name, name) == 0) return table[i].value;
+    return -1;
+}
+
+static const char* bench_name_of(const BenchName* table, size_t count, int value) {
+    for (size_t i = 0; i < count; i++)
+        if (table[i].value == value) return table[i].name;
+    return "?";
+}
+
+/* 解析逗号分隔的名字列表，返回个数，出错返回-1 */
+static int bench_parse_list(const char* arg, const BenchName* table, size_t count, int* out) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", arg);
+    int n = 0;
+    for (char* tok = strtok(buffer, ","); tok; tok = strtok(NULL, ",")) {
+        int value = bench_lookup(table, count, tok);
+        if (value < 0 || n == BENCH_MAX_LIST) return -1;
+        out[n++] = value;
+    }
+    return n > 0 ? n : -1;
+}
+
+static int bench_parse_size(const char* arg, size_t* out) {
+    char* end;
+    errno = 0;
+    unsigned long long v = strtoull(arg, &end, 10);
+    if (!isdigit((unsigned char)*arg) || *end != '\0' || errno == ERANGE || v > SIZE_MAX) return -1;
+    *out = (size_t)v;
+    return 0;
+}
+
+static void bench_usage(void) {
+    fprintf(stderr,
+            "用法: bubblesort --bench [--type int,float,double,string,pool,struct] [--n N]\n"
+            "                 [--algo intro,heap,insertion,bubble,radix,parallel,multikey,packed,stable]\n"
+            "                 [--repeats R] [--threads T]\n"
+            "                 [--dist random|sorted|reverse|nearly|organ|few|zipf|equal]\n"
+            "                 [--swaps K] [--unique U] [--zipf S]\n"
+            "                 [--seed S] [--format json|csv] [--perf]\n");
+}
+
+static int bench_parse_options(int argc, char* argv[], BenchOptions* opt) {
+    opt->types[0] = SORT_INT;
+    opt->type_count = 1;
+    opt->algorithms[0] = SORT_ALGO_INTRO;
+    opt->algorithm_count = 1;
+    opt->n = TEST_COUNT;
+    opt->repeats = 10;
+    opt->threads = 0;
+    memset(&opt->shape, 0, sizeof(opt->shape));
+    opt->shape.seed = BENCH_DEFAULT_SEED;
+    opt->csv = 0;
+    opt->perf = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* key = argv[i];
+        if (strcmp(key, "--bench") == 0) continue;
+        if (strcmp(key, "--perf") == 0) {
+            opt->perf = 1;
+            continue;
+        }
+        if (i + 1 >= argc) return -1;
+        const char* value = argv[++i];
+        size_t number;
+        int shape_rc = test_data_shape_option(key, value, &opt->shape);
+
+        if (shape_rc < 0) {
+            return -1;
+        } else if (shape_rc > 0) {
+            continue;
+        } else if (strcmp(key, "--type") == 0) {
+            opt->type_count = bench_parse_list(value, bench_types, BENCH_COUNT(bench_types), opt->types);
+            if (opt->type_count < 0) return -1;
+        } else if (strcmp(key, "--algo") == 0) {
+            opt->algorithm_count = bench_parse_list(value, bench_algorithms,
+                                                    BENCH_COUNT(bench_algorithms), opt->algorithms);
+            if (opt->algorithm_count < 0) return -1;
+        } else if (strcmp(key, "--format") == 0) {
+            if (strcmp(value, "csv") == 0) opt->csv = 1;
+            else if (strcmp(value, "json") == 0) opt->csv = 0;
+            else return -1;
+        } else if (bench_parse_size(value, &number) != 0) {
+            return -1;
+        } else if (strcmp(key, "--n") == 0) {
+            opt->n = number;
+        } else if (strcmp(key, "--repeats") == 0 && number > 0 && number <= 1000000) {
+            opt->repeats = (int)number;
+        } else if (strcmp(key, "--threads") == 0 && number <= 1024) {
+            opt->threads = (int)number;
+        } else {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t bench_rand32(CounterRng* rng) {
+    return (uint32_t)counter_rng_next(rng);
+}
+
+/* 5-18个字符的随机串，写入长度为MAX_STRING_LEN的槽位 */
+static void bench_random_name(CounterRng* rng, char* slot) {
+    static const char charset[] = "abcdefghijklmnopqrstuvwxyz"
+                                  "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                  "0123456789!@#$%^&*()";
+    int len = 5 + (int)counter_rng_below(rng, 14);
+    for (int j = 0; j < len; j++)
+        slot[j] = charset[counter_rng_below(rng, sizeof(charset) - 1)];
+    memset(slot + len, 0, MAX_STRING_LEN - len);
+}
+
+/* 结构体的hash与交互测试一致：名字MD5摘要的前4字节 */
+static void bench_hash_structs(TestData* data, size_t n) {
+    const uint8_t* msgs[BENCH_MD5_BATCH];
+    size_t lens[BENCH_MD5_BATCH];
+    uint8_t digests[BENCH_MD5_BATCH][MD5_DIGEST_SIZE];
+    for (size_t base = 0; base < n; base += BENCH_MD5_BATCH) {
+        size_t batch = n - base < BENCH_MD5_BATCH ? n - base : BENCH_MD5_BATCH;
+        for (size_t i = 0; i < batch; i++) {
+            msgs[i] = (const uint8_t*)data[base + i].name;
+            lens[i] = strlen(data[base + i].name);
+        }
+        md5_many(msgs, lens, batch, digests);
+        for (size_t i = 0; i < batch; i++)
+            memcpy(&data[base + i].hash, digests[i], sizeof(uint32_t));
+    }
+}
+
+/* 按类型生成n个随机元素，再按分布整理；SORT_STRING_POOL的元素先以char*生成。
+ * 元素i的随机数以(种子, 类型, i)初始化，字符串池与字符串得到相同的数据 */
+static void* bench_generate(SortType type, size_t n, const TestDataShape* shape, char** text) {
+    SortType elem_type = type == SORT_STRING_POOL ? SORT_STRING : type;
+    size_t element_size = sort_element_size(elem_type);
+    char* data = malloc(n * element_size + 1);
+    *text = NULL;
+    if (!data) return NULL;
+
+    if (elem_type == SORT_STRING) {
+        *text = malloc(n * MAX_STRING_LEN + 1);
+        if (!*text) {
+            free(data);
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        void* elem = data + i * element_size;
+        CounterRng rng;
+        counter_rng_init(&rng, shape->seed, (uint32_t)elem_type, i);
+        switch (elem_type) {
+            case SORT_INT: *(int*)elem = (int)bench_rand32(&rng); break;
+            case SORT_FLOAT: *(float*)elem = (float)(int32_t)bench_rand32(&rng) / 65536.0f; break;
+            case SORT_DOUBLE:
+                *(double*)elem = (double)(int32_t)bench_rand32(&rng) / 1024.0
+                               + bench_rand32(&rng) / 4294967296.0;
+                break;
+            case SORT_STRING:
+                bench_random_name(&rng, *text + i * MAX_STRING_LEN);
+                *(char**)elem = *text + i * MAX_STRING_LEN;
+                break;
+            case SORT_STRUCT: bench_random_name(&rng, ((TestData*)elem)->name); break;
+            default: break;
+        }
+    }
+    if (elem_type == SORT_STRUCT)
+        bench_hash_structs((TestData*)data, n);
+
+    if (test_data_distribute(data, n, element_size, sort_comparator(elem_type), shape) != 0) {
+        free(data);
+        free(*text);
+        *text = NULL;
+        return NULL;
+    }
+    return data;
+}
+
+static void bench_input_free(BenchInput* input) {
+    if (input->arr) sort_array_free(input->arr);
+    free(input->source);
+    free(input->text);
+    memset(input, 0, sizeof(*input));
+}
+
+static int bench_input_init(BenchInput* input, SortType type, const BenchOptions* opt) {
+    memset(input, 0, sizeof(*input));
+    void* elements = bench_generate(type, opt->n, &opt->shape, &input->text);
+    if (!elements) return -1;
+
+    size_t element_size = sort_element_size(type);
+    input->arr = sort_array_create(type);
+    if (sort_array_insert_bulk(input->arr, elements, opt->n) != 0) {
+        free(elements);
+        bench_input_free(input);
+        return -1;
+    }
+
+    // 字符串池的原始数据是插入后的条目；其他类型直接沿用生成的元素
+    if (type == SORT_STRING_POOL) {
+        free(elements);
+        elements = malloc(opt->n * element_size + 1);
+        if (!elements) {
+            bench_input_free(input);
+            return -1;
+        }
+        if (opt->n) memcpy(elements, input->arr->data, opt->n * element_size);
+    }
+    input->source = elements;
+    input->bytes = opt->n * element_size;
+    return 0;
+}
+
+static int bench_is_sorted(const SortArray* arr) {
+    size_t element_size = arr->element_size;
+    int (*compar)(const void*, const void*) = sort_comparator(arr->type);
+    for (size_t i = 1; i < arr->size; i++) {
+        const void* prev = (const char*)arr->data + (i - 1) * element_size;
+        const void* cur = (const char*)arr->data + i * element_size;
+        int c = arr->type == SORT_STRING_POOL
+            ? string_pool_compare(arr->pool, prev, cur)
+            : compar(prev, cur);
+        if (c > 0) return 0;
+    }
+    return 1;
+}
+
+/* 报告排序阶段的时间分布；吞吐量按中位数计算，另附重置阶段中位数 */
+static void bench_report(const BenchOptions* opt, int type, int algorithm, PhaseTimes* times,
+                         size_t bytes, int sorted, int first) {
+    TimerStats sort_stats, reset_stats;
+    timer_phase_stats(&times->time[PHASE_SORT], &sort_stats);
+    timer_phase_stats(&times->time[PHASE_RESET], &reset_stats);
+    double median = sort_stats.median;
+    double elements_per_s = median > 0 ? opt->n / median : 0;
+    double bytes_per_s = median > 0 ? bytes / median : 0;
+    int threads = opt->threads ? opt->threads : parallel_sort_default_threads();
+    const char* type_name = bench_name_of(bench_types, BENCH_COUNT(bench_types), type);
+    const char* algo_name = bench_name_of(bench_algorithms, BENCH_COUNT(bench_algorithms), algorithm);
+    const char* dist_name = test_distribution_name(opt->shape.distribution);
+
+    if (opt->csv) {
+        if (first) {
+            printf("type,algorithm,n,repeats,threads,distribution,seed,timer,"
+                   "min_s,median_s,p99_s,max_s,reset_median_s,elements_per_s,bytes_per_s,sorted");
+            for (int c = 0; opt->perf && c < PERF_COUNTER_COUNT; c++)
+                printf(",%s", perf_counter_name((PerfCounterId)c));
+            printf("\n");
+        }
+        printf("%s,%s,%zu,%d,%d,%s,%llu,%s,%.9f,%.9f,%.9f,%.9f,%.9f,%.6e,%.6e,%d",
+               type_name, algo_name, opt->n, opt->repeats, threads, dist_name,
+               (unsigned long long)opt->shape.seed,
+               timer_source(), sort_stats.min, median, sort_stats.p99, sort_stats.max,
+               reset_stats.median, elements_per_s, bytes_per_s, sorted);
+        for (int c = 0; opt->perf && c < PERF_COUNTER_COUNT; c++) {
+            double mean = phase_counter_mean(times, PHASE_SORT, (PerfCounterId)c);
+            if (mean < 0) printf(",");
+            else printf(",%.0f", mean);
+        }
+        printf("\n");
+    } else {
+        printf("%s  {\"type\": \"%s\", \"algorithm\": \"%s\", \"n\": %zu, \"repeats\": %d, "
+               "\"threads\": %d, \"distribution\": \"%s\", \"seed\": %llu, \"timer\": \"%s\", "
+               "\"min_s\": %.9f, \"median_s\": %.9f, \"p99_s\": %.9f, \"max_s\": %.9f, "
+               "\"reset_median_s\": %.9f, "
+               "\"elements_per_s\": %.6e, \"bytes_per_s\": %.6e, \"sorted\": %s",
+               first ? "[\n" : ",\n", type_name, algo_name, opt->n, opt->repeats, threads,
+               dist_name, (unsigned long long)opt->shape.seed, timer_source(), sort_stats.min, median, sort_stats.p99,
+               sort_stats.max, reset_stats.median, elements_per_s, bytes_per_s,
+               sorted ? "true" : "false");
+        if (opt->perf) {
+            printf(", \"counters\": {");
+            for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+                double mean = phase_counter_mean(times, PHASE_SORT, (PerfCounterId)c);
+                printf("%s\"%s\": ", c ? ", " : "", perf_counter_name((PerfCounterId)c));
+                if (mean < 0) printf("null");
+                else printf("%.0f", mean);
+            }
+            printf("}");
+        }
+        printf("}");
+    }
+}
+
+/* 返回0表示全部用例排序正确；参数错误或结果未排序时返回非0 */
+static int run_benchmark(int argc, char* argv[]) {
+    BenchOptions opt;
+    if (bench_parse_options(argc, argv, &opt) != 0) {
+        bench_usage();
+        return 2;
+    }
+
+    PhaseTimes times;
+    phase_times_init(&times);
+    int status = 0, first = 1;
+
+    for (int t = 0; t < opt.type_count; t++) {
+        BenchInput input;
+        if (bench_input_init(&input, (SortType)opt.types[t], &opt) != 0) {
+            fprintf(stderr, "生成测试数据失败: %s\n",
+                    bench_name_of(bench_types, BENCH_COUNT(bench_types), opt.types[t]));
+            status = 1;
+            continue;
+        }
+        sort_array_set_threads(input.arr, opt.threads);
+
+        for (int a = 0; a < opt.algorithm_count; a++) {
+            sort_array_set_algorithm(input.arr, (SortAlgorithm)opt.algorithms[a]);
+            phase_times_clear(&times);
+            for (int r = 0; r < opt.repeats; r++) {
+                PhaseMark m0, m1, m2;
+                phase_mark(&m0);
+                if (input.bytes)
+                    memcpy(input.arr->data, input.source, input.bytes);
+                phase_mark(&m1);
+                sort_array_sort(input.arr);
+                phase_mark(&m2);
+                phase_times_add(&times, PHASE_RESET, &m0, &m1);
+                phase_times_add(&times, PHASE_SORT, &m1, &m2);
+            }
+            int sorted = bench_is_sorted(input.arr);
+            if (!sorted) status = 1;
+            bench_report(&opt, opt.types[t], opt.algorithms[a], &times, input.bytes, sorted, first);
+            first = 0;
+        }
+        bench_input_free(&input);
+    }
+
+    if (!opt.csv) printf(first ? "[]\n" : "\n]\n");
+    phase_times_free(&times);
+    return status;
+}
+
+/* ===================== 批量输入排序模块 ===================== */
+/*
+ * 非交互批量排序：bubblesort --sort int|double|string [--input 文件] [--algo 算法] [--binary]
+ *   --input   输入文件（默认或"-"为标准输入），普通文件直接映射
+ *   --algo    同基准测试的算法名之一（默认intro）
+ *   --binary  按本机字节序输出int32/double原始字节，字符串以'\0'结尾依次输出
+ * 整数与浮点数以空白分隔，字符串每行一个。整块读入后手写解析，结果数组由SortArray直接接管；
+ * 字符串不复制，SortArray中的指针直接指向输入缓冲区。
+ * 文本输出每行一个值（浮点数等价于"%.17g"），经输出缓冲区批量写出。
+ */
+static void sort_input_usage(void) {
+    fprintf(stderr,
+            "用法: bubblesort --sort int|double|string [--input 文件] [--binary]\n"
+            "                 [--algo intro,heap,insertion,bubble,radix,parallel,multikey,packed,stable之一]\n");
+}
+
+/* 返回0表示成功；参数错误返回2，输入无法读取或解析失败返回1 */
+static int run_sort_input(int argc, char* argv[]) {
+    const char* path = NULL;
+    int type = -1, algorithm = SORT_ALGO_INTRO, binary = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--binary") == 0) {
+            binary = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            sort_input_usage();
+            return 2;
+        }
+        const char* value = argv[++i];
+        if (strcmp(argv[i - 1], "--sort") == 0) {
+            type = strcmp(value, "int") == 0      ? SORT_INT
+                   : strcmp(value, "double") == 0 ? SORT_DOUBLE
+                   : strcmp(value, "string") == 0 ? SORT_STRING
+                                                  : -1;
+        } else if (strcmp(argv[i - 1], "--input") == 0) {
+            path = value;
+        } else if (strcmp(argv[i - 1], "--algo") == 0) {
+            algorithm = bench_lookup(bench_algorithms, BENCH_COUNT(bench_algorithms), value);
+        } else {
+            algorithm = -1;
+        }
+        if (algorithm < 0) break;
+    }
+    if (type < 0 || algorithm < 0) {
+        sort_input_usage();
+        return 2;
+    }
+
+    InputBuffer in;
+    if (input_buffer_open(&in, path) != 0) {
+        fprintf(stderr, "无法读取输入: %s\n", path ? path : "-");
+        return 1;
+    }
+
+    void* items = NULL;
+    size_t count = 0;
+    int rc;
+    if (type == SORT_INT)
+        rc = fast_parse_ints(in.data, in.size, (int**)&items, &count);
+    else if (type == SORT_DOUBLE)
+        rc = fast_parse_doubles(in.data, in.size, (double**)&items, &count);
+    else
+        rc = fast_split_lines(in.data, in.size, (char***)&items, &count);
+    if (rc != 0) {
+        if (type == SORT_STRING) fprintf(stderr, "内存不足\n");
+        else fprintf(stderr, "输入格式错误: 第%zu个数值无效或超出范围\n", count + 1);
+        input_buffer_close(&in);
+        return 1;
+    }
+
+    SortArray* arr = sort_array_create((SortType)type);
+    sort_array_adopt(arr, items, count);
+    sort_array_set_algorithm(arr, (SortAlgorithm)algorithm);
+    sort_array_sort(arr);
+
+    OutputBuffer out;
+    output_buffer_init(&out, stdout, 0);
+    if (binary && type != SORT_STRING) {
+        output_write(&out, arr->data, arr->size * arr->element_size);
+    } else {
+        for (size_t i = 0; i < arr->size; i++) {
+            if (type == SORT_INT) output_int(&out, ((int*)arr->data)[i]);
+            else if (type == SORT_DOUBLE) output_double(&out, ((double*)arr->data)[i]);
+            else output_str(&out, ((char**)arr->data)[i]);
+            output_char(&out, binary ? '\0' : '\n');
+        }
+    }
+    int status = 0;
+    if (output_buffer_close(&out) != 0 || fflush(stdout) != 0) {
+        fprintf(stderr, "写出结果失败\n");
+        status = 1;
+    }
+
+    /* 字符串指向输入缓冲区，必须先释放数组再释放输入 */
+    sort_array_free(arr);
+    input_buffer_close(&in);
+    return status;
+}
+
 /* ===================== 主函数 ===================== */
-int main() {
+/*
+ * 用法：bubblesort [--dataset 文件] [--n 个数] [--dist 分布 ...] [--seed 种子] [--perf]
+ *       bubblesort --bench [选项]（见基准测试模块）
+ *       bubblesort --sort int|double|string [--input 文件] [--algo 算法] [--binary]（见批量输入排序模块）
+ * --n与分布选项（同基准测试）决定生成的测试数据，默认TEST_COUNT个均匀随机值；
+ * --perf在各计时阶段附带采集硬件性能计数器。
+ * 指定数据集文件时直接映射加载；文件不存在或无效时重新生成并写入该文件。
+ */
+int main(int argc, char* argv[]) {
+    const char* dataset_path = NULL;
+    size_t count = TEST_COUNT;
+    TestDataShape shape = { DIST_RANDOM, 0, 0, 0, 0 };
+    int bench = 0, sort_input = 0, perf = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0)
+            bench = 1;
+        else if (strcmp(argv[i], "--sort") == 0)
+            sort_input = 1;
+        else if (strcmp(argv[i], "--perf") == 0)
+            perf = 1;
+        else if (bench || sort_input || i + 1 >= argc)
+            continue;
+        else if (strcmp(argv[i], "--dataset") == 0)
+            dataset_path = argv[++i];
+        else if (strcmp(argv[i], "--n") == 0) {
+            if (bench_parse_size(argv[++i], &count) != 0) {
+                fprintf(stderr, "无效的元素个数: %s\n", argv[i]);
+                return 2;
+            }
+        }
+        else {
+            int shape_rc = test_data_shape_option(argv[i], argv[i + 1], &shape);
+            if (shape_rc < 0) {
+                fprintf(stderr, "无效的选项值: %s %s\n", argv[i], argv[i + 1]);
+                return 2;
+            }
+            if (shape_rc > 0) i++;
+        }
+    }
+    // --sort模式不计数，只在基准测试与默认测试中打开计数器
+    if (perf && (bench || !sort_input) && perf_counters_open(&perf_counters) == 0)
+        fprintf(stderr, "硬件性能计数器不可用，仅记录时间\n");
+    if (bench) {
+        int status = run_benchmark(argc, argv);
+        perf_counters_close(&perf_counters);
+        return status;
+    }
+    if (sort_input) return run_sort_input(argc, argv);
+
     printf("MD5测试结果: ");
     MD5_CTX ctx;
     uint8_t digest[MD5_DIGEST_SIZE];
@@ -545,7 +1890,20 @@ int main() {
     printf("\n\n");
     
     // 初始化测试数据
-    init_test_data();
+    if (dataset_path && test_data_load(dataset_path, 1) == 0) {
+        printf("已加载数据集文件: %s\n", dataset_path);
+    } else {
+        if (init_test_data_shaped(count, &shape) != 0) {
+            fprintf(stderr, "测试数据内存分配失败\n");
+            return 1;
+        }
+        if (dataset_path) {
+            if (test_data_save(dataset_path) == 0)
+                printf("已生成数据集文件: %s\n", dataset_path);
+            else
+                printf("数据集文件写入失败: %s\n", dataset_path);
+        }
+    }
     
     // 打印测试数据报告
     print_test_data();
@@ -553,5 +1911,6 @@ int main() {
     // 执行排序测试
     test_sort();
     
+    perf_counters_close(&perf_counters);
     return 0;
 }
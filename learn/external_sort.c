@@ -0,0 +1,434 @@
+/* external_sort.c - 超出内存的数据集的外部归并排序 */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <process.h>
+#define ext_getpid() ((unsigned long)_getpid())
+#else
+#include <unistd.h>
+#define ext_getpid() ((unsigned long)getpid())
+#endif
+#include "external_sort.h"
+
+/* 单趟归并的最大路数，顺串更多时先分组归并成更长的顺串 */
+#define EXT_MAX_FANIN 128
+/* 每个读写缓冲区的最小字节数 */
+#define EXT_MIN_BUFFER 4096
+#define EXT_DEFAULT_BUDGET ((size_t)64 << 20)
+
+typedef struct {
+    int lines;                 /* 1：换行分隔字符串，元素为char*；0：定长记录 */
+    size_t record_size;
+    int (*compar)(const void*, const void*);
+    ExternalRunSort run_sort;
+    size_t budget;
+    const char* tmp_dir;
+    size_t run_serial;         /* 具名临时文件编号 */
+} ExtJob;
+
+typedef struct {
+    FILE* fp;
+    char* path;                /* 具名临时文件路径；tmpfile()时为NULL */
+} ExtRun;
+
+/* 带缓冲的输入源：定长记录或行 */
+typedef struct {
+    FILE* fp;
+    char* buf;
+    size_t cap, start, end;
+    int eof;
+    char* line;                /* 行模式下的当前行，元素指针为&line */
+} ExtReader;
+
+typedef struct {
+    ExtRun* items;
+    size_t count, capacity;
+} ExtRunList;
+
+/* ===================== 临时顺串 ===================== */
+static int ext_run_open(ExtJob* job, ExtRun* run) {
+    run->path = NULL;
+    if (!job->tmp_dir) {
+        run->fp = tmpfile();
+        return run->fp ? 0 : -1;
+    }
+
+    size_t len = strlen(job->tmp_dir) + 64;
+    run->path = malloc(len);
+    if (!run->path) return -1;
+    snprintf(run->path, len, "%s/extsort_%lu_%zu.run", job->tmp_dir, ext_getpid(), job->run_serial++);
+    run->fp = fopen(run->path, "w+b");
+    if (!run->fp) {
+        free(run->path);
+        run->path = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void ext_run_close(ExtRun* run) {
+    if (run->fp) fclose(run->fp);
+    if (run->path) {
+        remove(run->path);
+        free(run->path);
+    }
+    run->fp = NULL;
+    run->path = NULL;
+}
+
+static int ext_runs_push(ExtRunList* list, ExtRun run) {
+    if (list->count == list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 16;
+        ExtRun* items = realloc(list->items, new_cap * sizeof(ExtRun));
+        if (!items) return -1;
+        list->items = items;
+        list->capacity = new_cap;
+    }
+    list->items[list->count++] = run;
+    return 0;
+}
+
+static void ext_runs_free(ExtRunList* list) {
+    for (size_t i = 0; i < list->count; i++)
+        ext_run_close(&list->items[i]);
+    free(list->items);
+    list->items = NULL;
+    list->count = list->capacity = 0;
+}
+
+/* ===================== 输入读取 ===================== */
+static int ext_reader_init(ExtReader* r, FILE* fp, size_t cap) {
+    r->fp = fp;
+    r->cap = cap < EXT_MIN_BUFFER ? EXT_MIN_BUFFER : cap;
+    r->buf = malloc(r->cap);
+    r->start = r->end = 0;
+    r->eof = 0;
+    r->line = NULL;
+    return r->buf ? 0 : -1;
+}
+
+/* 把未消费的数据移到缓冲区开头并尽量填满；need超过容量时扩容。扩容失败或读出错返回-1 */
+static int ext_reader_fill(ExtReader* r, size_t need) {
+    if (r->start > 0) {
+        memmove(r->buf, r->buf + r->start, r->end - r->start);
+        r->end -= r->start;
+        r->start = 0;
+    }
+    if (need > r->cap) {
+        size_t new_cap = r->cap * 2;
+        while (new_cap < need) new_cap *= 2;
+        char* buf = realloc(r->buf, new_cap);
+        if (!buf) return -1;
+        r->buf = buf;
+        r->cap = new_cap;
+    }
+    // 保留1字节给行模式末行的'\0'
+    size_t want = r->cap - r->end - 1;
+    size_t got = fread(r->buf + r->end, 1, want, r->fp);
+    r->end += got;
+    // 读不满可能是文件结束，也可能是I/O错误；后者不能当作结束，否则归并结果被静默截断
+    if (got < want && ferror(r->fp)) return -1;
+    if (got == 0) r->eof = 1;
+    return 0;
+}
+
+/* 取下一个元素：成功返回元素指针，结束返回NULL；出错时*err置为-1 */
+static const void* ext_reader_next(const ExtJob* job, ExtReader* r, int* err) {
+    if (!job->lines) {
+        while (r->end - r->start < job->record_size) {
+            if (r->eof) {
+                if (r->end != r->start) *err = -1; // 文件末尾有残缺记录
+                return NULL;
+            }
+            if (ext_reader_fill(r, job->record_size + 1) != 0) {
+                *err = -1;
+                return NULL;
+            }
+        }
+        const void* rec = r->buf + r->start;
+        r->start += job->record_size;
+        return rec;
+    }
+
+    for (;;) {
+        char* nl = memchr(r->buf + r->start, '\n', r->end - r->start);
+        if (nl) {
+            *nl = '\0';
+            r->line = r->buf + r->start;
+            r->start = (size_t)(nl - r->buf) + 1;
+            return &r->line;
+        }
+        if (r->eof) {
+            if (r->start == r->end) return NULL;
+            r->buf[r->end] = '\0'; // 最后一行没有换行符
+            r->line = r->buf + r->start;
+            r->start = r->end;
+            return &r->line;
+        }
+        // 当前行跨越缓冲区末尾：至少再留1字节数据和1字节'\0'，放不下时扩容
+        if (ext_reader_fill(r, r->end - r->start + 2) != 0) {
+            *err = -1;
+            return NULL;
+        }
+    }
+}
+
+static int ext_write_element(const ExtJob* job, FILE* out, const void* elem) {
+    if (!job->lines)
+        return fwrite(elem, job->record_size, 1, out) == 1 ? 0 : -1;
+    const char* line = *(char* const*)elem;
+    size_t len = strlen(line);
+    if (fwrite(line, 1, len, out) != len || fputc('\n', out) == EOF) return -1;
+    return 0;
+}
+
+/* ===================== 顺串生成 ===================== */
+static void ext_sort_chunk(const ExtJob* job, void* base, size_t n) {
+    if (n < 2) return;
+    if (job->run_sort)
+        job->run_sort(base, n, job->record_size, job->compar);
+    else
+        qsort(base, n, job->record_size, job->compar);
+}
+
+static int ext_write_chunk(const ExtJob* job, FILE* out, const char* base, size_t n) {
+    if (!job->lines)
+        return fwrite(base, job->record_size, n, out) == n ? 0 : -1;
+    for (size_t i = 0; i < n; i++)
+        if (ext_write_element(job, out, base + i * sizeof(char*)) != 0) return -1;
+    return 0;
+}
+
+/*
+ * 按内存预算切分输入，每块排序后写成一个顺串。
+ * 整个输入一块就装得下时直接写到out，*direct置1。
+ */
+static int ext_make_runs(ExtJob* job, FILE* in, FILE* out, ExtRunList* runs, int* direct) {
+    int rc = -1, err = 0;
+    ExtReader reader;
+    char* arena = NULL;     // 行模式：行字节
+    char* elems = NULL;     // 定长记录，或行模式下的char*数组
+    size_t max_elems, arena_cap = 0;
+
+    *direct = 0;
+    if (!job->lines) {
+        max_elems = job->budget / job->record_size;
+        if (max_elems == 0) max_elems = 1;
+        elems = malloc(max_elems * job->record_size);
+        if (!elems) return -1;
+    } else {
+        // 行模式：预算的3/4存放字节，1/4存放指针
+        arena_cap = job->budget / 4 * 3;
+        max_elems = job->budget / 4 / sizeof(char*);
+        if (max_elems == 0) max_elems = 1;
+        arena = malloc(arena_cap);
+        elems = malloc(max_elems * sizeof(char*));
+        if (!arena || !elems) goto done;
+    }
+    if (ext_reader_init(&reader, in, EXT_MIN_BUFFER * 16) != 0) goto done;
+
+    const void* elem = ext_reader_next(job, &reader, &err);
+    while (elem) {
+        size_t n = 0, used = 0;
+        while (elem && n < max_elems) {
+            if (!job->lines) {
+                memcpy(elems + n * job->record_size, elem, job->record_size);
+            } else {
+                const char* line = *(char* const*)elem;
+                size_t len = strlen(line) + 1;
+                // 超长单行独占一块时放宽预算；否则块满就结束本顺串
+                if (used + len > arena_cap) {
+                    if (n > 0) break;
+                    char* bigger = realloc(arena, len);
+                    if (!bigger) goto done_reader;
+                    arena = bigger;
+                    arena_cap = len;
+                }
+                memcpy(arena + used, line, len);
+                ((char**)elems)[n] = arena + used;
+                used += len;
+            }
+            n++;
+            elem = ext_reader_next(job, &reader, &err);
+        }
+        if (err) goto done_reader;
+
+        ext_sort_chunk(job, elems, n);
+        if (!elem && runs->count == 0) {
+            *direct = 1;
+            if (ext_write_chunk(job, out, elems, n) != 0) goto done_reader;
+            break;
+        }
+
+        ExtRun run;
+        if (ext_run_open(job, &run) != 0) goto done_reader;
+        if (ext_runs_push(runs, run) != 0) {
+            ext_run_close(&run);
+            goto done_reader;
+        }
+        if (ext_write_chunk(job, run.fp, elems, n) != 0) goto done_reader;
+    }
+    rc = err ? -1 : 0;
+
+done_reader:
+    free(reader.buf);
+done:
+    free(arena);
+    free(elems);
+    return rc;
+}
+
+/* ===================== 败者树归并 ===================== */
+typedef struct {
+    const ExtJob* job;
+    const void** cur;          /* 各路当前元素，NULL表示该路已耗尽 */
+    size_t* tree;              /* tree[0]为胜者，tree[1..k-1]为各内部结点的败者 */
+    size_t k;
+} ExtLoserTree;
+
+#define EXT_TREE_EMPTY ((size_t)-1)
+
+/* a是否胜过b：耗尽的一路视为无穷大，相等时编号小者胜以保持稳定 */
+static int ext_beats(const ExtLoserTree* lt, size_t a, size_t b) {
+    if (!lt->cur[a]) return 0;
+    if (!lt->cur[b]) return 1;
+    int c = lt->job->compar(lt->cur[a], lt->cur[b]);
+    return c < 0 || (c == 0 && a < b);
+}
+
+/* 叶子s的元素变化后沿路径向上重赛 */
+static void ext_tree_adjust(ExtLoserTree* lt, size_t s) {
+    for (size_t t = (s + lt->k) / 2; t > 0; t /= 2) {
+        if (lt->tree[t] == EXT_TREE_EMPTY) {
+            // 建树阶段：先到者在此等候另一侧子树的胜者
+            lt->tree[t] = s;
+            return;
+        }
+        if (ext_beats(lt, lt->tree[t], s)) {
+            size_t tmp = lt->tree[t];
+            lt->tree[t] = s;
+            s = tmp;
+        }
+    }
+    lt->tree[0] = s;
+}
+
+/* 归并k个顺串到out；顺串在读回前刷新并检查写入错误 */
+static int ext_merge(const ExtJob* job, ExtRun* sources, size_t k, FILE* out) {
+    int rc = -1, err = 0;
+    size_t buf_size = job->budget / (k + 1);
+    ExtReader* readers = calloc(k, sizeof(ExtReader));
+    ExtLoserTree lt;
+    lt.job = job;
+    lt.k = k;
+    lt.cur = calloc(k, sizeof(void*));
+    lt.tree = malloc(k * sizeof(size_t));
+    if (!readers || !lt.cur || !lt.tree) goto done;
+
+    for (size_t i = 0; i < k; i++) {
+        // rewind会清除错误标志：先确认顺串的缓冲数据全部写出（如磁盘已满），否则归并结果被截断
+        if (fflush(sources[i].fp) != 0 || ferror(sources[i].fp)) goto done;
+        rewind(sources[i].fp);
+        if (ext_reader_init(&readers[i], sources[i].fp, buf_size) != 0) goto done;
+        lt.cur[i] = ext_reader_next(job, &readers[i], &err);
+        if (err) goto done;
+    }
+
+    lt.tree[0] = 0;
+    for (size_t i = 1; i < k; i++)
+        lt.tree[i] = EXT_TREE_EMPTY;
+    for (size_t i = k; i-- > 0; )
+        ext_tree_adjust(&lt, i);
+
+    for (;;) {
+        size_t w = lt.tree[0];
+        if (!lt.cur[w]) break; // 胜者已耗尽说明全部耗尽
+        if (ext_write_element(job, out, lt.cur[w]) != 0) goto done;
+        lt.cur[w] = ext_reader_next(job, &readers[w], &err);
+        if (err) goto done;
+        ext_tree_adjust(&lt, w);
+    }
+    rc = 0;
+
+done:
+    if (readers)
+        for (size_t i = 0; i < k; i++)
+            free(readers[i].buf);
+    free(readers);
+    free(lt.cur);
+    free(lt.tree);
+    return rc;
+}
+
+/* 多趟归并：顺串数超过最大路数时，分组归并成新顺串，直到可一次归并到输出 */
+static int ext_merge_all(ExtJob* job, ExtRunList* runs, FILE* out) {
+    while (runs->count > EXT_MAX_FANIN) {
+        ExtRunList next = { NULL, 0, 0 };
+        for (size_t i = 0; i < runs->count; i += EXT_MAX_FANIN) {
+            size_t k = runs->count - i < EXT_MAX_FANIN ? runs->count - i : EXT_MAX_FANIN;
+            ExtRun merged;
+            if (ext_run_open(job, &merged) != 0 || ext_runs_push(&next, merged) != 0 ||
+                ext_merge(job, &runs->items[i], k, merged.fp) != 0) {
+                ext_runs_free(&next);
+                return -1;
+            }
+        }
+        ext_runs_free(runs);
+        *runs = next;
+    }
+    return ext_merge(job, runs->items, runs->count, out);
+}
+
+static int ext_sort(ExtJob* job, const char* in_path, const char* out_path) {
+    FILE* in = fopen(in_path, "rb");
+    if (!in) return -1;
+    FILE* out = fopen(out_path, "wb");
+    if (!out) {
+        fclose(in);
+        return -1;
+    }
+
+    ExtRunList runs = { NULL, 0, 0 };
+    int direct = 0;
+    int rc = ext_make_runs(job, in, out, &runs, &direct);
+    if (rc == 0 && !direct && runs.count > 0)
+        rc = ext_merge_all(job, &runs, out);
+
+    ext_runs_free(&runs);
+    fclose(in);
+    if (fclose(out) != 0) rc = -1;
+    return rc;
+}
+
+static void ext_job_init(ExtJob* job, const ExternalSortConfig* config) {
+    job->budget = (config && config->memory_budget) ? config->memory_budget : EXT_DEFAULT_BUDGET;
+    if (job->budget < EXT_MIN_BUFFER * 4) job->budget = EXT_MIN_BUFFER * 4;
+    job->tmp_dir = config ? config->tmp_dir : NULL;
+    job->run_sort = config ? config->run_sort : NULL;
+    job->run_serial = 0;
+}
+
+int external_sort_records(const char* in_path, const char* out_path, size_t record_size,
+                          int (*compar)(const void*, const void*),
+                          const ExternalSortConfig* config) {
+    if (record_size == 0 || !compar) return -1;
+    ExtJob job;
+    ext_job_init(&job, config);
+    job.lines = 0;
+    job.record_size = record_size;
+    job.compar = compar;
+    return ext_sort(&job, in_path, out_path);
+}
+
+int external_sort_lines(const char* in_path, const char* out_path,
+                        int (*compar)(const void*, const void*),
+                        const ExternalSortConfig* config) {
+    if (!compar) return -1;
+    ExtJob job;
+    ext_job_init(&job, config);
+    job.lines = 1;
+    job.record_size = sizeof(char*);
+    job.compar = compar;
+    return ext_sort(&job, in_path, out_path);
+}
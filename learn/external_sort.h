@@ -0,0 +1,33 @@
+/* external_sort.h - 超出内存的数据集的外部归并排序 */
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <stddef.h>
+
+/* 顺串内排序函数，签名与qsort相同 */
+typedef void (*ExternalRunSort)(void* base, size_t nmemb, size_t size,
+                                int (*compar)(const void*, const void*));
+
+typedef struct {
+    size_t memory_budget;     /* 生成顺串与归并时可用的内存字节数 */
+    const char* tmp_dir;      /* 临时顺串文件目录；NULL时使用tmpfile() */
+    ExternalRunSort run_sort; /* 顺串内排序；NULL时使用qsort */
+} ExternalSortConfig;
+
+/*
+ * 定长记录文件排序（int、double、TestData等），compar与内存排序使用的比较函数相同。
+ * 成功返回0；文件读写失败、内存不足或文件长度不是record_size整数倍时返回-1。
+ */
+int external_sort_records(const char* in_path, const char* out_path, size_t record_size,
+                          int (*compar)(const void*, const void*),
+                          const ExternalSortConfig* config);
+
+/*
+ * 换行分隔的字符串文件排序，compar的元素为char*（即compare_string的约定），
+ * 输出每行以'\n'结尾。成功返回0，失败返回-1。
+ */
+int external_sort_lines(const char* in_path, const char* out_path,
+                        int (*compar)(const void*, const void*),
+                        const ExternalSortConfig* config);
+
+#endif /* EXTERNAL_SORT_H */
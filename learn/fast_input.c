@@ -0,0 +1,287 @@
+/* fast_input.c - 大批量文本输入的整块读取与手写解析 */
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#define read _read
+#define close _close
+#endif
+#include "fast_input.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/* 标准输入或管道的初始读缓冲区，不够时倍增 */
+#define INPUT_READ_BLOCK ((size_t)1 << 20)
+/* 单次read的上限，避免超过平台read长度参数的范围 */
+#define INPUT_READ_MAX ((size_t)1 << 30)
+/* 解析结果数组的初始容量 */
+#define INPUT_INITIAL_COUNT 4096
+/* 尾数在2^53以内且10的幂不超过22时，一次乘除即可得到正确舍入的结果 */
+#define INPUT_EXACT_POW10 22
+
+static const double input_pow10[INPUT_EXACT_POW10 + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* 从fd读到EOF，缓冲区多留一个字节放'\0' */
+static int input_read_all(int fd, InputBuffer* in) {
+    size_t capacity = INPUT_READ_BLOCK;
+    char* data = malloc(capacity + 1);
+    size_t size = 0;
+    if (!data) return -1;
+    for (;;) {
+        if (size == capacity) {
+            char* grown = realloc(data, capacity * 2 + 1);
+            if (!grown) {
+                free(data);
+                return -1;
+            }
+            data = grown;
+            capacity *= 2;
+        }
+        size_t want = capacity - size;
+        if (want > INPUT_READ_MAX) want = INPUT_READ_MAX;
+        long got = (long)read(fd, data + size, (unsigned)want);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            free(data);
+            return -1;
+        }
+        if (got == 0) break;
+        size += (size_t)got;
+    }
+    data[size] = '\0';
+    in->data = data;
+    in->size = size;
+    in->mapped = 0;
+    return 0;
+}
+
+int input_buffer_open(InputBuffer* in, const char* path) {
+    memset(in, 0, sizeof(*in));
+    if (!path || strcmp(path, "-") == 0) return input_read_all(0, in);
+
+    int fd = open(path, O_RDONLY | O_BINARY);
+    if (fd < 0) return -1;
+#ifndef _WIN32
+    /* 文件长度不是页大小整数倍时，映射末页的剩余字节为0，正好作为结尾的'\0' */
+    struct stat st;
+    long page = sysconf(_SC_PAGESIZE);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && page > 0
+        && (uint64_t)st.st_size < (uint64_t)SIZE_MAX && st.st_size % page != 0) {
+        void* base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (base != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+            madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+            close(fd);
+            in->data = base;
+            in->size = (size_t)st.st_size;
+            in->mapped = (size_t)st.st_size;
+            return 0;
+        }
+    }
+#endif
+    int rc = input_read_all(fd, in);
+    close(fd);
+    return rc;
+}
+
+void input_buffer_close(InputBuffer* in) {
+#ifndef _WIN32
+    if (in->mapped) munmap(in->data, in->mapped);
+    else free(in->data);
+#else
+    free(in->data);
+#endif
+    memset(in, 0, sizeof(*in));
+}
+
+static inline int input_is_space(unsigned char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline int input_is_digit(unsigned char c) {
+    return (unsigned)(c - '0') < 10;
+}
+
+/* 结果数组按倍增扩容；失败时释放并返回-1 */
+static int input_grow(void** items, size_t* capacity, size_t count, size_t elem_size) {
+    if (count < *capacity) return 0;
+    size_t grown = *capacity ? *capacity * 2 : INPUT_INITIAL_COUNT;
+    void* data = realloc(*items, grown * elem_size);
+    if (!data) return -1;
+    *items = data;
+    *capacity = grown;
+    return 0;
+}
+
+int fast_parse_ints(const char* data, size_t size, int** out, size_t* count) {
+    const char* p = data;
+    const char* end = data + size;
+    int* items = NULL;
+    size_t n = 0, capacity = 0;
+
+    for (;;) {
+        while (p < end && input_is_space((unsigned char)*p)) p++;
+        if (p == end) break;
+
+        int neg = 0;
+        if (*p == '-' || *p == '+') neg = *p++ == '-';
+        if (p == end || !input_is_digit((unsigned char)*p)) goto fail;
+        uint64_t v = 0;
+        do {
+            v = v * 10 + (unsigned)(*p++ - '0');
+            if (v > (uint64_t)INT32_MAX + 1) goto fail;
+        } while (p < end && input_is_digit((unsigned char)*p));
+        if (p < end && !input_is_space((unsigned char)*p)) goto fail;
+        if (!neg && v > (uint64_t)INT32_MAX) goto fail;
+
+        if (input_grow((void**)&items, &capacity, n, sizeof(int)) != 0) goto fail;
+        items[n++] = neg ? (int)(-(int64_t)v) : (int)v;
+    }
+    *out = items;
+    *count = n;
+    return 0;
+
+fail:
+    free(items);
+    *out = NULL;
+    *count = n;
+    return -1;
+}
+
+/*
+ * 解析一个浮点记号[p, token_end)：十进制形式走快速路径，
+ * 有效位过多、指数过大或inf/nan/十六进制等形式交给strtod（要求data之后有'\0'）
+ */
+static int input_parse_double(const char* p, const char* token_end, double* value) {
+    const char* start = p;
+    int neg = 0;
+    if (*p == '-' || *p == '+') neg = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0, exp10 = 0, any = 0;
+    while (p < token_end && *p == '0') {
+        p++;
+        any = 1;
+    }
+    while (p < token_end && input_is_digit((unsigned char)*p)) {
+        if (digits < 19) mantissa = mantissa * 10 + (unsigned)(*p - '0');
+        else exp10++;
+        digits++;
+        p++;
+        any = 1;
+    }
+    if (p < token_end && *p == '.') {
+        p++;
+        if (digits == 0) {
+            while (p < token_end && *p == '0') {
+                p++;
+                exp10--;
+                any = 1;
+            }
+        }
+        while (p < token_end && input_is_digit((unsigned char)*p)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (unsigned)(*p - '0');
+                exp10--;
+            }
+            digits++;
+            p++;
+            any = 1;
+        }
+    }
+    if (any && p < token_end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        int eneg = 0, e = 0;
+        if (q < token_end && (*q == '-' || *q == '+')) eneg = *q++ == '-';
+        if (q < token_end && input_is_digit((unsigned char)*q)) {
+            while (q < token_end && input_is_digit((unsigned char)*q)) {
+                if (e < 100000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    if (any && p == token_end && digits <= 19 && mantissa <= ((uint64_t)1 << 53)
+        && exp10 >= -INPUT_EXACT_POW10 && exp10 <= INPUT_EXACT_POW10) {
+        double v = (double)mantissa;
+        v = exp10 < 0 ? v / input_pow10[-exp10] : v * input_pow10[exp10];
+        *value = neg ? -v : v;
+        return 0;
+    }
+
+    char* stop;
+    *value = strtod(start, &stop);
+    return stop == token_end ? 0 : -1;
+}
+
+int fast_parse_doubles(const char* data, size_t size, double** out, size_t* count) {
+    const char* p = data;
+    const char* end = data + size;
+    double* items = NULL;
+    size_t n = 0, capacity = 0;
+
+    for (;;) {
+        while (p < end && input_is_space((unsigned char)*p)) p++;
+        if (p == end) break;
+        const char* token_end = p;
+        while (token_end < end && !input_is_space((unsigned char)*token_end)) token_end++;
+
+        double v;
+        /* NaN无法参与排序比较，视同非法记号 */
+        if (input_parse_double(p, token_end, &v) != 0 || isnan(v)) goto fail;
+        if (input_grow((void**)&items, &capacity, n, sizeof(double)) != 0) goto fail;
+        items[n++] = v;
+        p = token_end;
+    }
+    *out = items;
+    *count = n;
+    return 0;
+
+fail:
+    free(items);
+    *out = NULL;
+    *count = n;
+    return -1;
+}
+
+int fast_split_lines(char* data, size_t size, char*** out, size_t* count) {
+    char* p = data;
+    char* end = data + size;
+    char** lines = NULL;
+    size_t n = 0, capacity = 0;
+
+    while (p < end) {
+        char* nl = memchr(p, '\n', (size_t)(end - p));
+        char* line_end = nl ? nl : end;
+        if (line_end > p && line_end[-1] == '\r') line_end[-1] = '\0';
+        if (nl) *nl = '\0';
+
+        if (input_grow((void**)&lines, &capacity, n, sizeof(char*)) != 0) {
+            free(lines);
+            *out = NULL;
+            *count = 0;
+            return -1;
+        }
+        lines[n++] = p;
+        p = line_end + 1;
+    }
+    *out = lines;
+    *count = n;
+    return 0;
+}
@@ -0,0 +1,35 @@
+/* fast_input.h - 大批量文本输入的整块读取与手写解析 */
+#ifndef FAST_INPUT_H
+#define FAST_INPUT_H
+
+#include <stddef.h>
+
+/* 整个输入的字节：普通文件私有映射，标准输入或管道按大块读入；末尾之后保证有一个'\0' */
+typedef struct {
+    char* data;
+    size_t size;
+    size_t mapped;       /* 非0时为映射长度，由munmap释放 */
+} InputBuffer;
+
+/* path为NULL或"-"时读取标准输入。成功返回0，打不开或读取失败返回-1 */
+int input_buffer_open(InputBuffer* in, const char* path);
+void input_buffer_close(InputBuffer* in);
+
+/*
+ * 以空白分隔的十进制整数/浮点数，解析结果写入malloc分配的数组（*out，个数*count），
+ * 可直接交给sort_array_adopt。成功返回0；遇到非法记号、超出int范围或nan时返回-1，
+ * *count为出错前已解析的个数，*out已释放。
+ * 浮点数在尾数不超过19位、十进制指数不超过22时直接精确计算，其余交给strtod，
+ * 因此data[size]必须可读且为'\0'（InputBuffer保证这一点）。
+ */
+int fast_parse_ints(const char* data, size_t size, int** out, size_t* count);
+int fast_parse_doubles(const char* data, size_t size, double** out, size_t* count);
+
+/*
+ * 按行切分：把换行（及其前面的'\r'）原地改写为'\0'，*out中的指针直接指向data，
+ * 不复制字符串；末行没有换行时依靠data之后的'\0'结束。最后一个换行之后的空行不计入。
+ * 成功返回0，内存不足返回-1。
+ */
+int fast_split_lines(char* data, size_t size, char*** out, size_t* count);
+
+#endif /* FAST_INPUT_H */
@@ -0,0 +1,253 @@
+/* fast_output.c - 排序结果的缓冲输出与专用数值格式化 */
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fast_output.h"
+
+/* 一个数值格式化后的最大字节数（"%.16e"为23字节，"%.17g"不超过24字节） */
+#define OUTPUT_NUMBER_MAX 32
+/* 有效数字最多17位 */
+#define OUTPUT_MAX_DIGITS 17
+
+static const char output_digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+void output_buffer_init(OutputBuffer* out, FILE* stream, size_t capacity) {
+    if (capacity < OUTPUT_MIN_CAPACITY) capacity = capacity ? OUTPUT_MIN_CAPACITY : OUTPUT_DEFAULT_CAPACITY;
+    out->stream = stream;
+    out->size = 0;
+    out->error = 0;
+    out->data = malloc(capacity);
+    out->capacity = capacity;
+    if (!out->data) {
+        out->data = out->small;
+        out->capacity = sizeof(out->small);
+    }
+}
+
+int output_flush(OutputBuffer* out) {
+    if (out->size && !out->error && fwrite(out->data, 1, out->size, out->stream) != out->size)
+        out->error = 1;
+    out->size = 0;
+    return out->error ? -1 : 0;
+}
+
+int output_buffer_close(OutputBuffer* out) {
+    output_flush(out);
+    if (out->data != out->small) free(out->data);
+    out->data = out->small;
+    out->capacity = sizeof(out->small);
+    return out->error ? -1 : 0;
+}
+
+void output_write(OutputBuffer* out, const void* data, size_t n) {
+    if (n == 0) return;
+    if (n > out->capacity / 2) {
+        output_flush(out);
+        if (!out->error && fwrite(data, 1, n, out->stream) != n) out->error = 1;
+        return;
+    }
+    memcpy(output_reserve(out, n), data, n);
+    out->size += n;
+}
+
+void output_str(OutputBuffer* out, const char* s) {
+    output_write(out, s, strlen(s));
+}
+
+/* 从p往前写v的十进制数字，返回首字节位置 */
+static char* output_format_uint(char* p, uint64_t v) {
+    while (v >= 100) {
+        const char* pair = &output_digit_pairs[(v % 100) * 2];
+        v /= 100;
+        *--p = pair[1];
+        *--p = pair[0];
+    }
+    if (v >= 10) {
+        *--p = output_digit_pairs[v * 2 + 1];
+        *--p = output_digit_pairs[v * 2];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    return p;
+}
+
+void output_uint(OutputBuffer* out, uint64_t v) {
+    char text[OUTPUT_NUMBER_MAX];
+    char* end = text + sizeof(text);
+    char* p = output_format_uint(end, v);
+    memcpy(output_reserve(out, (size_t)(end - p)), p, (size_t)(end - p));
+    out->size += (size_t)(end - p);
+}
+
+void output_int(OutputBuffer* out, int64_t v) {
+    char text[OUTPUT_NUMBER_MAX];
+    char* end = text + sizeof(text);
+    char* p = output_format_uint(end, v < 0 ? 0 - (uint64_t)v : (uint64_t)v);
+    if (v < 0) *--p = '-';
+    memcpy(output_reserve(out, (size_t)(end - p)), p, (size_t)(end - p));
+    out->size += (size_t)(end - p);
+}
+
+void output_hex32(OutputBuffer* out, uint32_t v) {
+    static const char hex[] = "0123456789ABCDEF";
+    char* p = output_reserve(out, 8);
+    for (int i = 7; i >= 0; i--) {
+        p[i] = hex[v & 0xF];
+        v >>= 4;
+    }
+    out->size += 8;
+}
+
+#if LDBL_MANT_DIG >= 64
+/* 10^0到10^27在64位尾数的long double中都能精确表示 */
+#define OUTPUT_EXACT_POW10 27
+static const long double output_pow10[OUTPUT_EXACT_POW10 + 1] = {
+    1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L,
+    1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L,
+    1e26L, 1e27L
+};
+#endif
+
+/*
+ * 把有限正数v舍入为precision+1位有效数字：*mantissa为数字串对应的整数，*exp10为首位的十进制指数。
+ * 用long double缩放后取整；缩放误差可能影响舍入方向（接近两数正中间）时返回-1，
+ * 由调用方交给snprintf，因此结果总与printf逐字节一致。long double不比double宽时总返回-1
+ */
+static int output_round_digits(double v, int precision, uint64_t* mantissa, int* exp10) {
+#if LDBL_MANT_DIG >= 64
+    long double low = output_pow10[precision];
+    long double high = output_pow10[precision + 1];
+    /* v在[2^(b-1), 2^b)内，由二进制指数估计十进制指数，至多偏小1 */
+    int b;
+    frexp(v, &b);
+    int e = (int)floor((b - 1) * 0.30102999566398119521);
+    long double scaled = 0, error = 0;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        int k = precision - e;
+        int a = k < 0 ? -k : k;
+        long double scale = a <= OUTPUT_EXACT_POW10 ? output_pow10[a] : powl(10.0L, a);
+        scaled = k >= 0 ? (long double)v * scale : (long double)v / scale;
+        /* 精确的10的幂只有一次舍入；powl的结果再多一次，留出余量 */
+        error = scaled * (a <= OUTPUT_EXACT_POW10 ? 0x1p-63L : 0x1p-60L);
+        if (scaled < low) e--;
+        else if (scaled >= high) e++;
+        else break;
+    }
+    if (scaled < low || scaled >= high) return -1;
+
+    long double whole = floorl(scaled);
+    long double frac = scaled - whole;
+    if (fabsl(frac - 0.5L) <= error) return -1;
+    uint64_t m = (uint64_t)whole + (frac > 0.5L);
+    if ((long double)m >= high) {
+        m /= 10;
+        e++;
+    }
+    *mantissa = m;
+    *exp10 = e;
+    return 0;
+#else
+    (void)v;
+    (void)precision;
+    (void)mantissa;
+    (void)exp10;
+    return -1;
+#endif
+}
+
+/* 写出"e±dd"形式的指数（至少两位），返回写入的字节数 */
+static size_t output_format_exponent(char* p, int e) {
+    size_t n = 0;
+    p[n++] = 'e';
+    p[n++] = e < 0 ? '-' : '+';
+    unsigned a = e < 0 ? (unsigned)-e : (unsigned)e;
+    if (a >= 100) p[n++] = (char)('0' + a / 100);
+    p[n++] = output_digit_pairs[(a % 100) * 2];
+    p[n++] = output_digit_pairs[(a % 100) * 2 + 1];
+    return n;
+}
+
+/* 无法快速格式化（inf/nan或舍入不确定）时走snprintf */
+static void output_double_printf(OutputBuffer* out, const char* format, int precision, double v) {
+    char* p = output_reserve(out, OUTPUT_NUMBER_MAX);
+    int n = snprintf(p, OUTPUT_NUMBER_MAX, format, precision, v);
+    if (n > 0) out->size += (size_t)n < OUTPUT_NUMBER_MAX ? (size_t)n : OUTPUT_NUMBER_MAX - 1;
+}
+
+void output_double_exp(OutputBuffer* out, double v, int precision) {
+    uint64_t m = 0;
+    int e = 0;
+    if (precision < 0 || precision > OUTPUT_MAX_DIGITS - 1 || !isfinite(v)
+        || (v != 0 && output_round_digits(fabs(v), precision, &m, &e) != 0)) {
+        output_double_printf(out, "%.*e", precision, v);
+        return;
+    }
+    char digits[OUTPUT_NUMBER_MAX];
+    char* end = digits + sizeof(digits);
+    char* d = end - (precision + 1);
+    memset(d, '0', (size_t)(precision + 1));
+    if (m) output_format_uint(end, m);
+
+    char* p = output_reserve(out, OUTPUT_NUMBER_MAX);
+    size_t n = 0;
+    if (signbit(v)) p[n++] = '-';
+    p[n++] = d[0];
+    if (precision > 0) {
+        p[n++] = '.';
+        memcpy(p + n, d + 1, (size_t)precision);
+        n += (size_t)precision;
+    }
+    n += output_format_exponent(p + n, e);
+    out->size += n;
+}
+
+void output_double(OutputBuffer* out, double v) {
+    uint64_t m = 0;
+    int e = 0;
+    if (!isfinite(v)
+        || (v != 0 && output_round_digits(fabs(v), OUTPUT_MAX_DIGITS - 1, &m, &e) != 0)) {
+        output_double_printf(out, "%.*g", OUTPUT_MAX_DIGITS, v);
+        return;
+    }
+    char digits[OUTPUT_NUMBER_MAX];
+    char* end = digits + sizeof(digits);
+    char* d = end - OUTPUT_MAX_DIGITS;
+    memset(d, '0', OUTPUT_MAX_DIGITS);
+    if (m) output_format_uint(end, m);
+    /* %g去掉尾部的0 */
+    int len = OUTPUT_MAX_DIGITS;
+    while (len > 1 && d[len - 1] == '0') len--;
+
+    char* p = output_reserve(out, OUTPUT_NUMBER_MAX);
+    size_t n = 0;
+    if (signbit(v)) p[n++] = '-';
+    if (e < -4 || e >= OUTPUT_MAX_DIGITS) {
+        p[n++] = d[0];
+        if (len > 1) {
+            p[n++] = '.';
+            memcpy(p + n, d + 1, (size_t)(len - 1));
+            n += (size_t)(len - 1);
+        }
+        n += output_format_exponent(p + n, e);
+    } else if (e < 0) {
+        p[n++] = '0';
+        p[n++] = '.';
+        for (int z = -1; z > e; z--) p[n++] = '0';
+        memcpy(p + n, d, (size_t)len);
+        n += (size_t)len;
+    } else {
+        int whole = e + 1;
+        memcpy(p + n, d, (size_t)whole);
+        n += (size_t)whole;
+        if (len > whole) {
+            p[n++] = '.';
+            memcpy(p + n, d + whole, (size_t)(len - whole));
+            n += (size_t)(len - whole);
+        }
+    }
+    out->size += n;
+}
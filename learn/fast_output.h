@@ -0,0 +1,56 @@
+/* fast_output.h - 排序结果的缓冲输出与专用数值格式化 */
+#ifndef FAST_OUTPUT_H
+#define FAST_OUTPUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* 默认缓冲区大小；申请失败时退回结构体内的小缓冲区 */
+#define OUTPUT_DEFAULT_CAPACITY ((size_t)1 << 20)
+#define OUTPUT_MIN_CAPACITY 4096
+
+/*
+ * 先在缓冲区内格式化，满了或结束时一次fwrite到stream。
+ * 经由stdio写出，与同一stream上的printf保持先后顺序（切换前调用output_flush）
+ */
+typedef struct {
+    FILE* stream;
+    char* data;
+    size_t size;
+    size_t capacity;
+    int error;                      /* 写出失败后置1，之后的输出被丢弃 */
+    char small[OUTPUT_MIN_CAPACITY];
+} OutputBuffer;
+
+/* capacity为0时使用OUTPUT_DEFAULT_CAPACITY */
+void output_buffer_init(OutputBuffer* out, FILE* stream, size_t capacity);
+/* 写出已缓冲的字节，缓冲区保留复用。成功返回0，失败返回-1 */
+int output_flush(OutputBuffer* out);
+/* 写出剩余字节并释放缓冲区；返回0表示全部输出成功 */
+int output_buffer_close(OutputBuffer* out);
+
+/* 原样输出n个字节，超过缓冲区一半的数据块直接写出，不经复制 */
+void output_write(OutputBuffer* out, const void* data, size_t n);
+void output_str(OutputBuffer* out, const char* s);
+void output_int(OutputBuffer* out, int64_t v);
+void output_uint(OutputBuffer* out, uint64_t v);
+/* 固定8位大写十六进制，等价于"%08X" */
+void output_hex32(OutputBuffer* out, uint32_t v);
+/* 等价于"%.*e"，precision为0到16 */
+void output_double_exp(OutputBuffer* out, double v, int precision);
+/* 等价于"%.17g"，足以精确还原原值 */
+void output_double(OutputBuffer* out, double v);
+
+/* 保证缓冲区至少还有n个字节空闲（n不超过OUTPUT_MIN_CAPACITY），返回写入位置 */
+static inline char* output_reserve(OutputBuffer* out, size_t n) {
+    if (out->capacity - out->size < n) output_flush(out);
+    return out->data + out->size;
+}
+
+static inline void output_char(OutputBuffer* out, char c) {
+    *output_reserve(out, 1) = c;
+    out->size++;
+}
+
+#endif /* FAST_OUTPUT_H */
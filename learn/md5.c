@@ -1,6 +1,11 @@
 /* md5.c - MD5哈希算法实现 */
 #include "md5.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MD5_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
 /* MD5常量表 */
 static const uint32_t MD5_K[64] = {
     0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
@@ -24,17 +29,41 @@ static const uint32_t MD5_K[64] = {
 /* 左旋转宏 */
 #define ROTATE_LEFT(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
 
-/* MD5核心转换函数 */
+/*
+ * 64步完全展开表：STEP(轮函数, a, b, c, d, 消息字下标, 移位, 常量下标)
+ * 每步计算 a = b + ROTATE_LEFT(a + 轮函数(b, c, d) + K + X, 移位)，
+ * 通过轮换a、b、c、d的位置省去每步的变量搬移。
+ */
+#define MD5_STEPS(STEP) \
+    STEP(F, a, b, c, d,  0,  7,  0) STEP(F, d, a, b, c,  1, 12,  1) STEP(F, c, d, a, b,  2, 17,  2) STEP(F, b, c, d, a,  3, 22,  3) \
+    STEP(F, a, b, c, d,  4,  7,  4) STEP(F, d, a, b, c,  5, 12,  5) STEP(F, c, d, a, b,  6, 17,  6) STEP(F, b, c, d, a,  7, 22,  7) \
+    STEP(F, a, b, c, d,  8,  7,  8) STEP(F, d, a, b, c,  9, 12,  9) STEP(F, c, d, a, b, 10, 17, 10) STEP(F, b, c, d, a, 11, 22, 11) \
+    STEP(F, a, b, c, d, 12,  7, 12) STEP(F, d, a, b, c, 13, 12, 13) STEP(F, c, d, a, b, 14, 17, 14) STEP(F, b, c, d, a, 15, 22, 15) \
+    STEP(G, a, b, c, d,  1,  5, 16) STEP(G, d, a, b, c,  6,  9, 17) STEP(G, c, d, a, b, 11, 14, 18) STEP(G, b, c, d, a,  0, 20, 19) \
+    STEP(G, a, b, c, d,  5,  5, 20) STEP(G, d, a, b, c, 10,  9, 21) STEP(G, c, d, a, b, 15, 14, 22) STEP(G, b, c, d, a,  4, 20, 23) \
+    STEP(G, a, b, c, d,  9,  5, 24) STEP(G, d, a, b, c, 14,  9, 25) STEP(G, c, d, a, b,  3, 14, 26) STEP(G, b, c, d, a,  8, 20, 27) \
+    STEP(G, a, b, c, d, 13,  5, 28) STEP(G, d, a, b, c,  2,  9, 29) STEP(G, c, d, a, b,  7, 14, 30) STEP(G, b, c, d, a, 12, 20, 31) \
+    STEP(H, a, b, c, d,  5,  4, 32) STEP(H, d, a, b, c,  8, 11, 33) STEP(H, c, d, a, b, 11, 16, 34) STEP(H, b, c, d, a, 14, 23, 35) \
+    STEP(H, a, b, c, d,  1,  4, 36) STEP(H, d, a, b, c,  4, 11, 37) STEP(H, c, d, a, b,  7, 16, 38) STEP(H, b, c, d, a, 10, 23, 39) \
+    STEP(H, a, b, c, d, 13,  4, 40) STEP(H, d, a, b, c,  0, 11, 41) STEP(H, c, d, a, b,  3, 16, 42) STEP(H, b, c, d, a,  6, 23, 43) \
+    STEP(H, a, b, c, d,  9,  4, 44) STEP(H, d, a, b, c, 12, 11, 45) STEP(H, c, d, a, b, 15, 16, 46) STEP(H, b, c, d, a,  2, 23, 47) \
+    STEP(I, a, b, c, d,  0,  6, 48) STEP(I, d, a, b, c,  7, 10, 49) STEP(I, c, d, a, b, 14, 15, 50) STEP(I, b, c, d, a,  5, 21, 51) \
+    STEP(I, a, b, c, d, 12,  6, 52) STEP(I, d, a, b, c,  3, 10, 53) STEP(I, c, d, a, b, 10, 15, 54) STEP(I, b, c, d, a,  1, 21, 55) \
+    STEP(I, a, b, c, d,  8,  6, 56) STEP(I, d, a, b, c, 15, 10, 57) STEP(I, c, d, a, b,  6, 15, 58) STEP(I, b, c, d, a, 13, 21, 59) \
+    STEP(I, a, b, c, d,  4,  6, 60) STEP(I, d, a, b, c, 11, 10, 61) STEP(I, c, d, a, b,  2, 15, 62) STEP(I, b, c, d, a,  9, 21, 63)
+
+#ifdef MD5_REFERENCE
+/* MD5核心转换函数（参考实现：逐步循环，用于验证展开版本） */
 static void md5_transform(uint32_t state[4], const uint8_t block[MD5_BLOCK_SIZE]) {
     uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
     uint32_t x[16];
     
     // 将块转换为32位整数数组（小端序）
     for (int i = 0; i < 16; i++) {
-        x[i] = (block[i*4]) |
-               (block[i*4+1] << 8) |
-               (block[i*4+2] << 16) |
-               (block[i*4+3] << 24);
+        x[i] = (uint32_t)block[i*4] |
+               ((uint32_t)block[i*4+1] << 8) |
+               ((uint32_t)block[i*4+2] << 16) |
+               ((uint32_t)block[i*4+3] << 24);
     }
 
     /* 四轮操作 */
@@ -75,6 +104,45 @@ static void md5_transform(uint32_t state[4], const uint8_t block[MD5_BLOCK_SIZE]
     state[3] += d;
 }
 
+#else
+/* 轮函数：F、G改写为等价的异或形式，少一次取反 */
+#define MD5_ROUND_F(b, c, d) ((d) ^ ((b) & ((c) ^ (d))))
+#define MD5_ROUND_G(b, c, d) ((c) ^ ((d) & ((b) ^ (c))))
+#define MD5_ROUND_H(b, c, d) ((b) ^ (c) ^ (d))
+#define MD5_ROUND_I(b, c, d) ((c) ^ ((b) | ~(d)))
+
+#define MD5_SCALAR_STEP(fn, a, b, c, d, g, s, i) \
+    a = b + ROTATE_LEFT(a + (x[g] + MD5_K[i]) + MD5_ROUND_##fn(b, c, d), s);
+
+/* 按小端序直接读取32位字 */
+static inline uint32_t md5_load_le32(const uint8_t* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+#else
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
+/* MD5核心转换函数（完全展开：常量、移位和消息字下标均在编译期确定） */
+static void md5_transform(uint32_t state[4], const uint8_t block[MD5_BLOCK_SIZE]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t x[16];
+
+    for (int i = 0; i < 16; i++)
+        x[i] = md5_load_le32(block + i * 4);
+
+    MD5_STEPS(MD5_SCALAR_STEP)
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+#endif /* MD5_REFERENCE */
+
 /* 初始化MD5上下文 */
 void md5_init(MD5_CTX* ctx) {
     ctx->state[0] = 0x67452301;
@@ -89,12 +157,13 @@ void md5_init(MD5_CTX* ctx) {
 void md5_update(MD5_CTX* ctx, const uint8_t* input, size_t input_len) {
     uint32_t index = (ctx->count[0] >> 3) & 0x3F;
     
-    // 更新位计数器
-    ctx->count[0] += (input_len << 3);
-    if (ctx->count[0] < (input_len << 3)) {
+    // 更新位计数器（低32位按无符号回绕进位，单次输入超过512MB时也正确）
+    uint32_t bits_low = (uint32_t)(input_len << 3);
+    ctx->count[0] += bits_low;
+    if (ctx->count[0] < bits_low) {
         ctx->count[1]++;
     }
-    ctx->count[1] += (input_len >> 29);
+    ctx->count[1] += (uint32_t)(input_len >> 29);
     
     uint32_t part_len = MD5_BLOCK_SIZE - index;
     const uint8_t* p = input;
@@ -147,3 +216,266 @@ void md5_final(MD5_CTX* ctx, uint8_t digest[MD5_DIGEST_SIZE]) {
         digest[i*4+3] = (ctx->state[i] >> 24) & 0xFF;
     }
 }
+
+/* ===================== 多缓冲批量MD5 ===================== */
+#define MD5_MAX_LANES 8
+
+/* 每条通道的一块消息已按列存放：words[i][lane]为该通道第i个消息字 */
+typedef void (*md5_lanes_fn)(uint32_t state[4][MD5_MAX_LANES],
+                             const uint32_t words[16][MD5_MAX_LANES]);
+
+#ifdef MD5_SIMD_X86
+#define MD5_V4_F(b, c, d) _mm_or_si128(_mm_and_si128(b, c), _mm_andnot_si128(b, d))
+#define MD5_V4_G(b, c, d) _mm_or_si128(_mm_and_si128(d, b), _mm_andnot_si128(d, c))
+#define MD5_V4_H(b, c, d) _mm_xor_si128(_mm_xor_si128(b, c), d)
+#define MD5_V4_I(b, c, d) _mm_xor_si128(c, _mm_or_si128(b, _mm_xor_si128(d, ones)))
+#define MD5_V4_ROTL(x, n) _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define MD5_V4_STEP(fn, a, b, c, d, g, s, i) \
+    a = _mm_add_epi32(b, MD5_V4_ROTL(_mm_add_epi32(_mm_add_epi32(a, MD5_V4_##fn(b, c, d)), \
+                                     _mm_add_epi32(_mm_set1_epi32((int)MD5_K[i]), x[g])), s));
+
+/* SSE2：4条通道并行 */
+static __attribute__((target("sse2")))
+void md5_transform_sse2(uint32_t state[4][MD5_MAX_LANES],
+                        const uint32_t words[16][MD5_MAX_LANES]) {
+    __m128i x[16];
+    for (int i = 0; i < 16; i++)
+        x[i] = _mm_loadu_si128((const __m128i*)words[i]);
+
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m128i a = _mm_loadu_si128((const __m128i*)state[0]);
+    __m128i b = _mm_loadu_si128((const __m128i*)state[1]);
+    __m128i c = _mm_loadu_si128((const __m128i*)state[2]);
+    __m128i d = _mm_loadu_si128((const __m128i*)state[3]);
+    __m128i a0 = a, b0 = b, c0 = c, d0 = d;
+
+    MD5_STEPS(MD5_V4_STEP)
+
+    _mm_storeu_si128((__m128i*)state[0], _mm_add_epi32(a, a0));
+    _mm_storeu_si128((__m128i*)state[1], _mm_add_epi32(b, b0));
+    _mm_storeu_si128((__m128i*)state[2], _mm_add_epi32(c, c0));
+    _mm_storeu_si128((__m128i*)state[3], _mm_add_epi32(d, d0));
+}
+
+#define MD5_V8_F(b, c, d) _mm256_or_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d))
+#define MD5_V8_G(b, c, d) _mm256_or_si256(_mm256_and_si256(d, b), _mm256_andnot_si256(d, c))
+#define MD5_V8_H(b, c, d) _mm256_xor_si256(_mm256_xor_si256(b, c), d)
+#define MD5_V8_I(b, c, d) _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, ones)))
+#define MD5_V8_ROTL(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define MD5_V8_STEP(fn, a, b, c, d, g, s, i) \
+    a = _mm256_add_epi32(b, MD5_V8_ROTL(_mm256_add_epi32(_mm256_add_epi32(a, MD5_V8_##fn(b, c, d)), \
+                                        _mm256_add_epi32(_mm256_set1_epi32((int)MD5_K[i]), x[g])), s));
+
+/* AVX2：8条通道并行 */
+static __attribute__((target("avx2")))
+void md5_transform_avx2(uint32_t state[4][MD5_MAX_LANES],
+                        const uint32_t words[16][MD5_MAX_LANES]) {
+    __m256i x[16];
+    for (int i = 0; i < 16; i++)
+        x[i] = _mm256_loadu_si256((const __m256i*)words[i]);
+
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m256i a = _mm256_loadu_si256((const __m256i*)state[0]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)state[1]);
+    __m256i c = _mm256_loadu_si256((const __m256i*)state[2]);
+    __m256i d = _mm256_loadu_si256((const __m256i*)state[3]);
+    __m256i a0 = a, b0 = b, c0 = c, d0 = d;
+
+    MD5_STEPS(MD5_V8_STEP)
+
+    _mm256_storeu_si256((__m256i*)state[0], _mm256_add_epi32(a, a0));
+    _mm256_storeu_si256((__m256i*)state[1], _mm256_add_epi32(b, b0));
+    _mm256_storeu_si256((__m256i*)state[2], _mm256_add_epi32(c, c0));
+    _mm256_storeu_si256((__m256i*)state[3], _mm256_add_epi32(d, d0));
+}
+#endif /* MD5_SIMD_X86 */
+
+/* 生成消息的第blk个（已填充的）64字节块，nblocks为填充后的总块数 */
+static void md5_padded_block(const uint8_t* msg, size_t len, size_t blk, size_t nblocks,
+                             uint8_t out[MD5_BLOCK_SIZE]) {
+    size_t off = blk * MD5_BLOCK_SIZE;
+    size_t take = 0;
+    if (off < len)
+        take = (len - off < MD5_BLOCK_SIZE) ? len - off : MD5_BLOCK_SIZE;
+
+    memcpy(out, msg + off, take);
+    memset(out + take, 0, MD5_BLOCK_SIZE - take);
+    if (len >= off && len - off < MD5_BLOCK_SIZE)
+        out[len - off] = 0x80;
+    if (blk == nblocks - 1) {
+        uint64_t bit_count = (uint64_t)len << 3;
+        for (int i = 0; i < 8; i++)
+            out[56 + i] = (bit_count >> (i * 8)) & 0xFF;
+    }
+}
+
+/* 多缓冲调度：每条通道处理完一条消息后立即换入下一条 */
+static void md5_many_lanes(const uint8_t** msgs, const size_t* lens, size_t n,
+                           uint8_t digests[][MD5_DIGEST_SIZE], int lanes, md5_lanes_fn transform) {
+    uint32_t state[4][MD5_MAX_LANES];
+    uint32_t words[16][MD5_MAX_LANES];
+    size_t job[MD5_MAX_LANES], block[MD5_MAX_LANES], nblocks[MD5_MAX_LANES];
+    int active[MD5_MAX_LANES];
+    uint8_t buf[MD5_BLOCK_SIZE];
+    size_t next = 0;
+    int running = 0;
+
+    memset(state, 0, sizeof(state));
+    memset(words, 0, sizeof(words));
+    for (int l = 0; l < MD5_MAX_LANES; l++)
+        active[l] = 0;
+
+    for (;;) {
+        // 空闲通道领取新消息
+        for (int l = 0; l < lanes; l++) {
+            if (active[l] || next >= n) continue;
+            job[l] = next++;
+            block[l] = 0;
+            nblocks[l] = (lens[job[l]] + 8) / MD5_BLOCK_SIZE + 1;
+            state[0][l] = 0x67452301;
+            state[1][l] = 0xEFCDAB89;
+            state[2][l] = 0x98BADCFE;
+            state[3][l] = 0x10325476;
+            active[l] = 1;
+            running++;
+        }
+        if (running == 0) break;
+
+        // 按列装载各通道当前块，空闲通道的计算结果直接丢弃
+        for (int l = 0; l < lanes; l++) {
+            if (!active[l]) continue;
+            md5_padded_block(msgs[job[l]], lens[job[l]], block[l], nblocks[l], buf);
+            for (int i = 0; i < 16; i++)
+                words[i][l] = (uint32_t)buf[i*4] |
+                              ((uint32_t)buf[i*4+1] << 8) |
+                              ((uint32_t)buf[i*4+2] << 16) |
+                              ((uint32_t)buf[i*4+3] << 24);
+        }
+
+        transform(state, words);
+
+        for (int l = 0; l < lanes; l++) {
+            if (!active[l] || ++block[l] < nblocks[l]) continue;
+            uint8_t* digest = digests[job[l]];
+            for (int i = 0; i < 4; i++) {
+                digest[i*4]   = (state[i][l]) & 0xFF;
+                digest[i*4+1] = (state[i][l] >> 8) & 0xFF;
+                digest[i*4+2] = (state[i][l] >> 16) & 0xFF;
+                digest[i*4+3] = (state[i][l] >> 24) & 0xFF;
+            }
+            active[l] = 0;
+            running--;
+        }
+    }
+}
+
+/* 批量计算n条消息的MD5，结果与逐条调用md5_init/md5_update/md5_final一致 */
+void md5_many(const uint8_t** msgs, const size_t* lens, size_t n,
+              uint8_t digests[][MD5_DIGEST_SIZE]) {
+#ifdef MD5_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        md5_many_lanes(msgs, lens, n, digests, 8, md5_transform_avx2);
+        return;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        md5_many_lanes(msgs, lens, n, digests, 4, md5_transform_sse2);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        MD5_CTX ctx;
+        md5_init(&ctx);
+        md5_update(&ctx, msgs[i], lens[i]);
+        md5_final(&ctx, digests[i]);
+    }
+}
+
+/* ===================== 摘要缓存 ===================== */
+static uint64_t md5_cache_fingerprint(const uint8_t* input, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= input[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static MD5_CACHE_ENTRY* md5_cache_probe(MD5_CACHE_ENTRY* slots, size_t capacity,
+                                        uint64_t fp, const uint8_t* input, size_t len) {
+    size_t mask = capacity - 1;
+    for (size_t i = (size_t)fp & mask; ; i = (i + 1) & mask) {
+        MD5_CACHE_ENTRY* e = &slots[i];
+        if (!e->used) return e;
+        if (e->fingerprint == fp && e->len == len && memcmp(e->key, input, len) == 0)
+            return e;
+    }
+}
+
+static int md5_cache_grow(MD5_CACHE* cache) {
+    size_t new_cap = cache->capacity * 2;
+    MD5_CACHE_ENTRY* slots = calloc(new_cap, sizeof(MD5_CACHE_ENTRY));
+    if (!slots) return -1;
+    for (size_t i = 0; i < cache->capacity; i++) {
+        MD5_CACHE_ENTRY* e = &cache->slots[i];
+        if (e->used)
+            *md5_cache_probe(slots, new_cap, e->fingerprint, e->key, e->len) = *e;
+    }
+    free(cache->slots);
+    cache->slots = slots;
+    cache->capacity = new_cap;
+    return 0;
+}
+
+int md5_cache_init(MD5_CACHE* cache, size_t capacity) {
+    size_t cap = 16;
+    while (cap < capacity) cap <<= 1;
+    cache->slots = calloc(cap, sizeof(MD5_CACHE_ENTRY));
+    cache->capacity = cache->slots ? cap : 0;
+    cache->count = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    return cache->slots ? 0 : -1;
+}
+
+void md5_cache_free(MD5_CACHE* cache) {
+    free(cache->slots);
+    cache->slots = NULL;
+    cache->capacity = 0;
+    cache->count = 0;
+}
+
+void md5_cached(MD5_CACHE* cache, const uint8_t* input, size_t input_len,
+                uint8_t digest[MD5_DIGEST_SIZE]) {
+    MD5_CACHE_ENTRY* e = NULL;
+    uint64_t fp = 0;
+
+    if (cache->slots && input_len <= MD5_CACHE_KEY_MAX) {
+        fp = md5_cache_fingerprint(input, input_len);
+        e = md5_cache_probe(cache->slots, cache->capacity, fp, input, input_len);
+        if (e->used) {
+            cache->hits++;
+            memcpy(digest, e->digest, MD5_DIGEST_SIZE);
+            return;
+        }
+    }
+
+    cache->misses++;
+    MD5_CTX ctx;
+    md5_init(&ctx);
+    md5_update(&ctx, input, input_len);
+    md5_final(&ctx, digest);
+    if (!e) return;
+
+    // 装载因子保持在3/4以下；扩容失败时仍可使用当前表，只是不再插入新键
+    if ((cache->count + 1) * 4 > cache->capacity * 3) {
+        if (md5_cache_grow(cache) != 0) return;
+        e = md5_cache_probe(cache->slots, cache->capacity, fp, input, input_len);
+    }
+    e->fingerprint = fp;
+    e->used = 1;
+    e->len = (uint8_t)input_len;
+    memcpy(e->key, input, input_len);
+    memcpy(e->digest, digest, MD5_DIGEST_SIZE);
+    cache->count++;
+}
@@ -17,9 +17,40 @@ typedef struct {
     uint8_t buffer[MD5_BLOCK_SIZE]; /* 输入缓冲区 */
 } MD5_CTX;
 
+/* MD5摘要缓存：开放寻址哈希表，键为消息字节，适合基数远小于调用次数的场景 */
+#define MD5_CACHE_KEY_MAX 32  /* 可缓存的最大消息长度，更长的消息直接计算 */
+
+typedef struct {
+    uint64_t fingerprint; /* 键的FNV-1a哈希 */
+    uint8_t used;
+    uint8_t len;
+    uint8_t key[MD5_CACHE_KEY_MAX];
+    uint8_t digest[MD5_DIGEST_SIZE];
+} MD5_CACHE_ENTRY;
+
+typedef struct {
+    MD5_CACHE_ENTRY* slots;
+    size_t capacity;      /* 槽位数，2的幂 */
+    size_t count;
+    size_t hits;          /* 命中次数 */
+    size_t misses;        /* 未命中（含无法缓存的长消息）次数 */
+} MD5_CACHE;
+
 /* MD5函数声明 */
 void md5_init(MD5_CTX* ctx);
 void md5_update(MD5_CTX* ctx, const uint8_t* input, size_t input_len);
 void md5_final(MD5_CTX* ctx, uint8_t digest[MD5_DIGEST_SIZE]);
 
+/* 批量计算多条独立消息的MD5：按CPU支持选择AVX2(8路)/SSE2(4路)多缓冲实现，
+ * 结果与逐条计算逐位一致；digests[i]接收msgs[i]的摘要 */
+void md5_many(const uint8_t** msgs, const size_t* lens, size_t n,
+              uint8_t digests[][MD5_DIGEST_SIZE]);
+
+/* 摘要缓存：init成功返回0；capacity为初始槽位数，装载过高时自动扩容 */
+int md5_cache_init(MD5_CACHE* cache, size_t capacity);
+void md5_cache_free(MD5_CACHE* cache);
+/* 计算input的MD5，命中缓存时直接返回已存摘要 */
+void md5_cached(MD5_CACHE* cache, const uint8_t* input, size_t input_len,
+                uint8_t digest[MD5_DIGEST_SIZE]);
+
 #endif /* MD5_H */
\ No newline at end of file
@@ -0,0 +1,270 @@
+/* parallel_sort.c - 基于pthreads的并行样本排序 */
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "parallel_sort.h"
+
+/* 每个线程至少分到的元素数，低于此规模直接单线程排序 */
+#define PSORT_MIN_PER_THREAD 16384
+/* 每个线程对应的桶数，桶越多负载越均衡 */
+#define PSORT_BUCKETS_PER_THREAD 4
+/* 每个桶的过采样倍数 */
+#define PSORT_OVERSAMPLE 32
+#define PSORT_MAX_THREADS 256
+
+#define PSORT_ELEM(base, i, size) ((char*)(base) + (size_t)(i) * (size))
+
+typedef struct {
+    /* 输入与参数 */
+    char* base;
+    size_t nmemb;
+    size_t size;
+    int (*compar)(const void*, const void*);
+    ParallelBucketSort bucket_sort;
+    int threads;
+
+    /* 去重后的分隔元素：桶2i为(s[i-1], s[i])开区间，桶2i+1为等于s[i]的元素 */
+    char* splitters;
+    size_t nsplit;
+    size_t nbuckets;
+
+    char* scratch;
+    uint16_t* bucket_of;     /* 每个元素所属的桶 */
+    size_t* counts;          /* [线程][桶] 计数，分发阶段复用为写入偏移 */
+    size_t* bucket_start;    /* 各桶在scratch中的起始位置，共nbuckets+1项 */
+
+    pthread_mutex_t lock;
+    size_t next_bucket;
+} PSortJob;
+
+typedef struct {
+    PSortJob* job;
+    int id;
+} PSortWorker;
+
+int parallel_sort_default_threads(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#else
+    return 1;
+#endif
+}
+
+/* 二分查找元素所在的桶 */
+static size_t psort_classify(const PSortJob* job, const void* elem) {
+    size_t lo = 0, hi = job->nsplit;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (job->compar(PSORT_ELEM(job->splitters, mid, job->size), elem) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    // lo为第一个不小于elem的分隔元素
+    if (lo < job->nsplit && job->compar(PSORT_ELEM(job->splitters, lo, job->size), elem) == 0)
+        return 2 * lo + 1;
+    return 2 * lo;
+}
+
+static void psort_chunk(const PSortJob* job, int id, size_t* begin, size_t* end) {
+    size_t per = job->nmemb / job->threads;
+    *begin = per * id;
+    *end = (id == job->threads - 1) ? job->nmemb : *begin + per;
+}
+
+/* 阶段一：分类并计数 */
+static void* psort_classify_worker(void* arg) {
+    PSortWorker* w = arg;
+    PSortJob* job = w->job;
+    size_t begin, end;
+    psort_chunk(job, w->id, &begin, &end);
+
+    size_t* counts = job->counts + (size_t)w->id * job->nbuckets;
+    for (size_t i = begin; i < end; i++) {
+        size_t b = psort_classify(job, PSORT_ELEM(job->base, i, job->size));
+        job->bucket_of[i] = (uint16_t)b;
+        counts[b]++;
+    }
+    return NULL;
+}
+
+/* 阶段二：按偏移分发到scratch */
+static void* psort_scatter_worker(void* arg) {
+    PSortWorker* w = arg;
+    PSortJob* job = w->job;
+    size_t begin, end;
+    psort_chunk(job, w->id, &begin, &end);
+
+    size_t* offsets = job->counts + (size_t)w->id * job->nbuckets;
+    for (size_t i = begin; i < end; i++) {
+        size_t dst = offsets[job->bucket_of[i]]++;
+        memcpy(PSORT_ELEM(job->scratch, dst, job->size),
+               PSORT_ELEM(job->base, i, job->size), job->size);
+    }
+    return NULL;
+}
+
+/* 阶段三：动态领取桶，排序后写回原数组 */
+static void* psort_sort_worker(void* arg) {
+    PSortWorker* w = arg;
+    PSortJob* job = w->job;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        size_t b = job->next_bucket++;
+        pthread_mutex_unlock(&job->lock);
+        if (b >= job->nbuckets) break;
+
+        size_t start = job->bucket_start[b];
+        size_t n = job->bucket_start[b + 1] - start;
+        if (n == 0) continue;
+
+        char* bucket = PSORT_ELEM(job->scratch, start, job->size);
+        // 等值桶内元素全部相等，无需排序
+        if (n > 1 && (b & 1) == 0) {
+            if (job->bucket_sort)
+                job->bucket_sort(bucket, n, job->size, job->compar);
+            else
+                qsort(bucket, n, job->size, job->compar);
+        }
+        memcpy(PSORT_ELEM(job->base, start, job->size), bucket, n * job->size);
+    }
+    return NULL;
+}
+
+static int psort_run_phase(PSortJob* job, void* (*fn)(void*)) {
+    pthread_t tids[PSORT_MAX_THREADS];
+    PSortWorker workers[PSORT_MAX_THREADS];
+    int started = 0, rc = 0;
+
+    for (int t = 0; t < job->threads; t++) {
+        workers[t].job = job;
+        workers[t].id = t;
+        if (pthread_create(&tids[t], NULL, fn, &workers[t]) != 0) {
+            rc = -1;
+            break;
+        }
+        started++;
+    }
+    for (int t = 0; t < started; t++)
+        pthread_join(tids[t], NULL);
+    return rc;
+}
+
+/* 抽样并生成去重后的分隔元素 */
+static int psort_choose_splitters(PSortJob* job) {
+    size_t want = (size_t)job->threads * PSORT_BUCKETS_PER_THREAD;
+    size_t nsample = want * PSORT_OVERSAMPLE;
+    if (nsample > job->nmemb) nsample = job->nmemb;
+
+    char* sample = malloc(nsample * job->size);
+    job->splitters = malloc(want * job->size);
+    if (!sample || !job->splitters) {
+        free(sample);
+        return -1;
+    }
+
+    // 固定种子的线性同余抽样，结果可复现
+    uint64_t state = 0x9E3779B97F4A7C15ull ^ job->nmemb;
+    for (size_t i = 0; i < nsample; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        size_t idx = (size_t)((state >> 33) % job->nmemb);
+        memcpy(PSORT_ELEM(sample, i, job->size), PSORT_ELEM(job->base, idx, job->size), job->size);
+    }
+    qsort(sample, nsample, job->size, job->compar);
+
+    job->nsplit = 0;
+    for (size_t k = 1; k < want; k++) {
+        const char* cand = PSORT_ELEM(sample, k * nsample / want, job->size);
+        if (job->nsplit > 0 &&
+            job->compar(PSORT_ELEM(job->splitters, job->nsplit - 1, job->size), cand) == 0)
+            continue;
+        memcpy(PSORT_ELEM(job->splitters, job->nsplit, job->size), cand, job->size);
+        job->nsplit++;
+    }
+    job->nbuckets = 2 * job->nsplit + 1;
+
+    free(sample);
+    return 0;
+}
+
+int parallel_sample_sort(void* base, size_t nmemb, size_t size,
+                         int (*compar)(const void*, const void*),
+                         ParallelBucketSort bucket_sort, int threads) {
+    if (threads <= 0) threads = parallel_sort_default_threads();
+    if (threads > PSORT_MAX_THREADS) threads = PSORT_MAX_THREADS;
+    if ((size_t)threads > nmemb / PSORT_MIN_PER_THREAD)
+        threads = (int)(nmemb / PSORT_MIN_PER_THREAD);
+
+    if (threads <= 1) {
+        if (nmemb < 2) return 0;
+        if (bucket_sort)
+            bucket_sort(base, nmemb, size, compar);
+        else
+            qsort(base, nmemb, size, compar);
+        return 0;
+    }
+
+    PSortJob job;
+    memset(&job, 0, sizeof(job));
+    job.base = base;
+    job.nmemb = nmemb;
+    job.size = size;
+    job.compar = compar;
+    job.bucket_sort = bucket_sort;
+    job.threads = threads;
+
+    int rc = -1;
+    if (psort_choose_splitters(&job) != 0) goto cleanup;
+
+    job.scratch = malloc(nmemb * size);
+    job.bucket_of = malloc(nmemb * sizeof(uint16_t));
+    job.counts = calloc((size_t)threads * job.nbuckets, sizeof(size_t));
+    job.bucket_start = malloc((job.nbuckets + 1) * sizeof(size_t));
+    if (!job.scratch || !job.bucket_of || !job.counts || !job.bucket_start) goto cleanup;
+    pthread_mutex_init(&job.lock, NULL);
+
+    if (psort_run_phase(&job, psort_classify_worker) != 0) goto cleanup_lock;
+
+    // 按桶优先、线程次之做前缀和，counts就地变为各线程的写入偏移
+    size_t sum = 0;
+    for (size_t b = 0; b < job.nbuckets; b++) {
+        job.bucket_start[b] = sum;
+        for (int t = 0; t < threads; t++) {
+            size_t* c = &job.counts[(size_t)t * job.nbuckets + b];
+            size_t n = *c;
+            *c = sum;
+            sum += n;
+        }
+    }
+    job.bucket_start[job.nbuckets] = sum;
+
+    if (psort_run_phase(&job, psort_scatter_worker) != 0) goto cleanup_lock;
+    // 到这里base仍是原始数据；若排序阶段线程启动不足，剩余的桶由当前线程完成
+    if (psort_run_phase(&job, psort_sort_worker) != 0) {
+        PSortWorker self = { &job, 0 };
+        psort_sort_worker(&self);
+    }
+    rc = 0;
+
+cleanup_lock:
+    pthread_mutex_destroy(&job.lock);
+cleanup:
+    free(job.splitters);
+    free(job.scratch);
+    free(job.bucket_of);
+    free(job.counts);
+    free(job.bucket_start);
+    return rc;
+}
@@ -0,0 +1,24 @@
+/* parallel_sort.h - 基于pthreads的并行样本排序 */
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <stddef.h>
+
+/* 桶内排序函数，签名与qsort相同 */
+typedef void (*ParallelBucketSort)(void* base, size_t nmemb, size_t size,
+                                   int (*compar)(const void*, const void*));
+
+/* 在线CPU数，至少为1 */
+int parallel_sort_default_threads(void);
+
+/*
+ * 并行样本排序：抽样选出分隔元素，多线程分类、分发到各桶，
+ * 并发排序各桶后写回base（原地结果）。
+ * threads <= 0 时使用在线CPU数；bucket_sort为NULL时桶内使用qsort。
+ * 成功返回0，内存或线程创建失败返回-1（此时base内容未被修改）。
+ */
+int parallel_sample_sort(void* base, size_t nmemb, size_t size,
+                         int (*compar)(const void*, const void*),
+                         ParallelBucketSort bucket_sort, int threads);
+
+#endif /* PARALLEL_SORT_H */
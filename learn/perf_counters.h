@@ -0,0 +1,48 @@
+/* perf_counters.h - 基于perf_event_open的硬件性能计数器 */
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_COUNTER_COUNT
+} PerfCounterId;
+
+/* 各计数器独立打开，某个事件不被支持时其余仍可使用。
+ * 零初始化的结构体表示未启用，读取为空操作 */
+typedef struct {
+    int enabled;
+    int fd[PERF_COUNTER_COUNT];  /* 不可用的计数器为-1 */
+} PerfCounters;
+
+/* 某一时刻各计数器的累计值（已按多路复用比例换算） */
+typedef struct {
+    uint64_t value[PERF_COUNTER_COUNT];
+} PerfSnapshot;
+
+/* 一个阶段多次采样的累计增量 */
+typedef struct {
+    uint64_t total[PERF_COUNTER_COUNT];
+    size_t samples;
+} PerfPhase;
+
+/* 打开计数器（仅统计用户态，覆盖之后创建的线程），返回可用个数；
+ * 非Linux平台、内核不支持或权限不足时返回0，此时结构体保持未启用 */
+int perf_counters_open(PerfCounters* pc);
+void perf_counters_close(PerfCounters* pc);
+int perf_counter_available(const PerfCounters* pc, PerfCounterId id);
+const char* perf_counter_name(PerfCounterId id);
+
+/* 读取快照；未启用或不可用的计数器记为0 */
+void perf_counters_read(const PerfCounters* pc, PerfSnapshot* snap);
+
+void perf_phase_clear(PerfPhase* phase);
+void perf_phase_add(PerfPhase* phase, const PerfSnapshot* begin, const PerfSnapshot* end);
+
+#endif /* PERF_COUNTERS_H */
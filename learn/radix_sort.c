@@ -0,0 +1,175 @@
+/* radix_sort.c - 数值类型的LSD基数排序 */
+#include <stdlib.h>
+#include <string.h>
+#include "radix_sort.h"
+
+/* 32位键用4趟8位数位，64位键用6趟11位数位（最后一趟9位） */
+#define RADIX_U32_BITS 8
+#define RADIX_U32_PASSES 4
+#define RADIX_U32_BUCKETS (1 << RADIX_U32_BITS)
+
+#define RADIX_U64_BITS 11
+#define RADIX_U64_PASSES 6
+#define RADIX_U64_BUCKETS (1 << RADIX_U64_BITS)
+
+#define SIGN_BIT_32 0x80000000u
+#define SIGN_BIT_64 0x8000000000000000ull
+
+/* 在keys与scratch之间来回分配，返回存放结果的那一个 */
+static uint32_t* radix_passes_u32(uint32_t* keys, uint32_t* scratch, size_t* histogram, size_t n) {
+    size_t (*hist)[RADIX_U32_BUCKETS] = (size_t (*)[RADIX_U32_BUCKETS])histogram;
+    memset(histogram, 0, RADIX_U32_HIST_SIZE * sizeof(size_t));
+
+    // 一次扫描统计所有数位的直方图
+    for (size_t i = 0; i < n; i++) {
+        uint32_t k = keys[i];
+        for (int p = 0; p < RADIX_U32_PASSES; p++)
+            hist[p][(k >> (p * RADIX_U32_BITS)) & (RADIX_U32_BUCKETS - 1)]++;
+    }
+
+    uint32_t* src = keys;
+    uint32_t* dst = scratch;
+    for (int p = 0; p < RADIX_U32_PASSES; p++) {
+        int shift = p * RADIX_U32_BITS;
+        size_t* h = hist[p];
+
+        // 所有元素该数位相同，本趟不改变顺序，直接跳过
+        if (h[(src[0] >> shift) & (RADIX_U32_BUCKETS - 1)] == n) continue;
+
+        size_t sum = 0;
+        for (int b = 0; b < RADIX_U32_BUCKETS; b++) {
+            size_t c = h[b];
+            h[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t k = src[i];
+            dst[h[(k >> shift) & (RADIX_U32_BUCKETS - 1)]++] = k;
+        }
+        uint32_t* t = src; src = dst; dst = t;
+    }
+    return src;
+}
+
+static uint64_t* radix_passes_u64(uint64_t* keys, uint64_t* scratch, size_t* histogram, size_t n) {
+    size_t (*hist)[RADIX_U64_BUCKETS] = (size_t (*)[RADIX_U64_BUCKETS])histogram;
+    memset(histogram, 0, RADIX_U64_HIST_SIZE * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = keys[i];
+        for (int p = 0; p < RADIX_U64_PASSES; p++)
+            hist[p][(k >> (p * RADIX_U64_BITS)) & (RADIX_U64_BUCKETS - 1)]++;
+    }
+
+    uint64_t* src = keys;
+    uint64_t* dst = scratch;
+    for (int p = 0; p < RADIX_U64_PASSES; p++) {
+        int shift = p * RADIX_U64_BITS;
+        size_t* h = hist[p];
+
+        if (h[(src[0] >> shift) & (RADIX_U64_BUCKETS - 1)] == n) continue;
+
+        size_t sum = 0;
+        for (int b = 0; b < RADIX_U64_BUCKETS; b++) {
+            size_t c = h[b];
+            h[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint64_t k = src[i];
+            dst[h[(k >> shift) & (RADIX_U64_BUCKETS - 1)]++] = k;
+        }
+        uint64_t* t = src; src = dst; dst = t;
+    }
+    return src;
+}
+
+void radix_sort_u32(uint32_t* keys, uint32_t* scratch, size_t* hist, size_t n) {
+    uint32_t* sorted = radix_passes_u32(keys, scratch, hist, n);
+    if (sorted != keys) memcpy(keys, sorted, n * sizeof(uint32_t));
+}
+
+void radix_sort_u64(uint64_t* keys, uint64_t* scratch, size_t* hist, size_t n) {
+    uint64_t* sorted = radix_passes_u64(keys, scratch, hist, n);
+    if (sorted != keys) memcpy(keys, sorted, n * sizeof(uint64_t));
+}
+
+/*
+ * 一次分配直方图与若干个n元素的键数组：直方图放在最前，保证size_t对齐。
+ * 分配失败或大小溢出时返回NULL
+ */
+static char* radix_alloc(size_t hist_size, size_t n, size_t key_size, size_t arrays) {
+    if (n > (SIZE_MAX - hist_size * sizeof(size_t)) / key_size / arrays) return NULL;
+    return malloc(hist_size * sizeof(size_t) + n * key_size * arrays);
+}
+
+/* 有符号整数：翻转符号位。int与uint32_t是同一类型的有符号/无符号版本，可以原地按无符号访问 */
+int radix_sort_int(int* data, size_t n) {
+    if (n < 2) return 0;
+    char* block = radix_alloc(RADIX_U32_HIST_SIZE, n, sizeof(uint32_t), 1);
+    if (!block) return -1;
+    size_t* hist = (size_t*)block;
+    uint32_t* scratch = (uint32_t*)(block + RADIX_U32_HIST_SIZE * sizeof(size_t));
+
+    uint32_t* keys = (uint32_t*)data;
+    for (size_t i = 0; i < n; i++)
+        keys[i] ^= SIGN_BIT_32;
+    radix_sort_u32(keys, scratch, hist, n);
+    for (size_t i = 0; i < n; i++)
+        keys[i] ^= SIGN_BIT_32;
+
+    free(block);
+    return 0;
+}
+
+/*
+ * IEEE 754：负数按位取反，非负数置符号位，得到与数值同序的无符号键。
+ * 浮点数组不能按整数类型访问（严格别名），键经memcpy转入独立的缓冲区排序，再经memcpy写回
+ */
+int radix_sort_float(float* data, size_t n) {
+    if (n < 2) return 0;
+    char* block = radix_alloc(RADIX_U32_HIST_SIZE, n, sizeof(uint32_t), 2);
+    if (!block) return -1;
+    size_t* hist = (size_t*)block;
+    uint32_t* keys = (uint32_t*)(block + RADIX_U32_HIST_SIZE * sizeof(size_t));
+    uint32_t* scratch = keys + n;
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        keys[i] = (bits & SIGN_BIT_32) ? ~bits : (bits | SIGN_BIT_32);
+    }
+    uint32_t* sorted = radix_passes_u32(keys, scratch, hist, n);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t k = sorted[i];
+        uint32_t bits = (k & SIGN_BIT_32) ? (k ^ SIGN_BIT_32) : ~k;
+        memcpy(&data[i], &bits, sizeof(bits));
+    }
+
+    free(block);
+    return 0;
+}
+
+int radix_sort_double(double* data, size_t n) {
+    if (n < 2) return 0;
+    char* block = radix_alloc(RADIX_U64_HIST_SIZE, n, sizeof(uint64_t), 2);
+    if (!block) return -1;
+    size_t* hist = (size_t*)block;
+    uint64_t* keys = (uint64_t*)(block + RADIX_U64_HIST_SIZE * sizeof(size_t));
+    uint64_t* scratch = keys + n;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t bits;
+        memcpy(&bits, &data[i], sizeof(bits));
+        keys[i] = (bits & SIGN_BIT_64) ? ~bits : (bits | SIGN_BIT_64);
+    }
+    uint64_t* sorted = radix_passes_u64(keys, scratch, hist, n);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = sorted[i];
+        uint64_t bits = (k & SIGN_BIT_64) ? (k ^ SIGN_BIT_64) : ~k;
+        memcpy(&data[i], &bits, sizeof(bits));
+    }
+
+    free(block);
+    return 0;
+}
@@ -0,0 +1,23 @@
+/* radix_sort.h - 数值类型的LSD基数排序 */
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 各趟数位直方图所需的size_t个数（32位键4趟×256桶，64位键6趟×2048桶） */
+#define RADIX_U32_HIST_SIZE (4 * 256)
+#define RADIX_U64_HIST_SIZE (6 * 2048)
+
+/* 无符号键排序：scratch至少容纳n个元素，hist为对应HIST_SIZE个size_t的工作区，结果写回keys */
+void radix_sort_u32(uint32_t* keys, uint32_t* scratch, size_t* hist, size_t n);
+void radix_sort_u64(uint64_t* keys, uint64_t* scratch, size_t* hist, size_t n);
+
+/* 数值排序：映射为保序无符号键后排序，再映射回原类型；直方图与键缓冲区一次从堆上分配。
+ * float/double的键在独立缓冲区中排序（2n个键），int原地排序（n个键）
+ * 成功返回0，临时缓冲区分配失败返回-1（数据保持不变） */
+int radix_sort_int(int* data, size_t n);
+int radix_sort_float(float* data, size_t n);
+int radix_sort_double(double* data, size_t n);
+
+#endif /* RADIX_SORT_H */
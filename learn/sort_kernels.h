@@ -0,0 +1,215 @@
+/* sort_kernels.h - 类型特化排序内核（宏生成） */
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+#include <stddef.h>
+
+/* 分区长度不超过该值时改用插入排序 */
+#define SORT_KERNEL_INSERTION_THRESHOLD 16
+
+/*
+ * SORT_DEFINE_KERNELS(name, T, LESS)
+ * 为元素类型T生成一组静态排序函数：
+ *   sort_insertion_##name(T* base, size_t n)
+ *   sort_heap_##name(T* base, size_t n)
+ *   sort_intro_##name(T* base, size_t n)
+ *   sort_kernel_##name(void* base, size_t n, size_t size, compar)
+ *     与qsort同签名的适配器，忽略size与compar，供通用排序框架回调
+ * LESS(a, b)接收两个const T*，a严格小于b时为真。
+ * 比较与交换都在编译期确定，编译器可以完全内联，
+ * 不再经过函数指针和按运行期大小的memcpy。
+ */
+#define SORT_DEFINE_KERNELS(name, T, LESS)                                     \
+    SORT_DEFINE_KERNELS_LEAF(name, T, LESS,                                    \
+                             SORT_KERNEL_INSERTION_THRESHOLD,                  \
+                             sort_insertion_##name)
+
+/*
+ * SORT_DEFINE_KERNELS_LEAF(name, T, LESS, LEAF_MAX, LEAF)
+ * 同上，但内省排序中长度不超过LEAF_MAX的分区交给LEAF(T* base, size_t n)，
+ * 用于接入SIMD排序网络等专用小块内核。
+ */
+#define SORT_DEFINE_KERNELS_LEAF(name, T, LESS, LEAF_MAX, LEAF)                \
+                                                                               \
+static inline void sort_swap_##name(T* a, T* b) {                              \
+    T tmp = *a;                                                                \
+    *a = *b;                                                                   \
+    *b = tmp;                                                                  \
+}                                                                              \
+                                                                               \
+static void sort_insertion_##name(T* base, size_t n) {                         \
+    for (size_t i = 1; i < n; i++) {                                           \
+        T v = base[i];                                                         \
+        size_t j = i;                                                          \
+        while (j > 0 && LESS(&v, &base[j - 1])) {                              \
+            base[j] = base[j - 1];                                             \
+            j--;                                                               \
+        }                                                                      \
+        base[j] = v;                                                           \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void sort_sift_down_##name(T* base, size_t root, size_t n) {            \
+    T v = base[root];                                                          \
+    for (;;) {                                                                 \
+        size_t child = 2 * root + 1;                                           \
+        if (child >= n) break;                                                 \
+        if (child + 1 < n && LESS(&base[child], &base[child + 1]))             \
+            child++;                                                           \
+        if (!LESS(&v, &base[child])) break;                                    \
+        base[root] = base[child];                                              \
+        root = child;                                                          \
+    }                                                                          \
+    base[root] = v;                                                            \
+}                                                                              \
+                                                                               \
+static void sort_heap_##name(T* base, size_t n) {                              \
+    if (n < 2) return;                                                         \
+    for (size_t i = n / 2; i-- > 0; )                                          \
+        sort_sift_down_##name(base, i, n);                                     \
+    for (size_t end = n - 1; end > 0; end--) {                                 \
+        sort_swap_##name(base, &base[end]);                                    \
+        sort_sift_down_##name(base, 0, end);                                   \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static inline T* sort_median3_##name(T* a, T* b, T* c) {                       \
+    return LESS(a, b)                                                          \
+        ? (LESS(b, c) ? b : (LESS(a, c) ? c : a))                              \
+        : (LESS(c, b) ? b : (LESS(c, a) ? c : a));                             \
+}                                                                              \
+                                                                               \
+static void sort_intro_loop_##name(T* base, size_t n, int depth) {             \
+    while (n > (LEAF_MAX)) {                                                   \
+        if (depth-- == 0) {                                                    \
+            sort_heap_##name(base, n);                                         \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        T* lo = base;                                                          \
+        T* mid = base + n / 2;                                                 \
+        T* hi = base + n - 1;                                                  \
+        if (n > 128) {                                                         \
+            size_t step = n / 8;                                               \
+            lo = sort_median3_##name(lo, lo + step, lo + 2 * step);            \
+            mid = sort_median3_##name(mid - step, mid, mid + step);            \
+            hi = sort_median3_##name(hi - 2 * step, hi - step, hi);            \
+        }                                                                      \
+        sort_swap_##name(base, sort_median3_##name(lo, mid, hi));              \
+                                                                               \
+        size_t i = 0, j = n;                                                   \
+        for (;;) {                                                             \
+            while (++i < n && LESS(&base[i], base));                           \
+            while (LESS(base, &base[--j]));                                    \
+            if (i >= j) break;                                                 \
+            sort_swap_##name(&base[i], &base[j]);                              \
+        }                                                                      \
+        sort_swap_##name(base, &base[j]);                                      \
+                                                                               \
+        if (j < n - j - 1) {                                                   \
+            sort_intro_loop_##name(base, j, depth);                            \
+            base += j + 1;                                                     \
+            n -= j + 1;                                                        \
+        } else {                                                               \
+            sort_intro_loop_##name(base + j + 1, n - j - 1, depth);            \
+            n = j;                                                             \
+        }                                                                      \
+    }                                                                          \
+    LEAF(base, n);                                                             \
+}                                                                              \
+                                                                               \
+static void sort_intro_##name(T* base, size_t n) {                             \
+    int depth = 0;                                                             \
+    for (size_t m = n; m > 1; m >>= 1)                                         \
+        depth += 2;                                                            \
+    sort_intro_loop_##name(base, n, depth);                                    \
+}                                                                              \
+                                                                               \
+static inline void sort_kernel_##name(void* base, size_t n, size_t size,       \
+                                      int (*compar)(const void*, const void*)) {\
+    (void)size;                                                                \
+    (void)compar;                                                              \
+    sort_intro_##name((T*)base, n);                                            \
+}
+
+/*
+ * SORT_DEFINE_SELECT(name, T, LESS)
+ * 在同名SORT_DEFINE_KERNELS之后使用，生成选择与部分排序：
+ *   sort_heap_select_##name(T* base, size_t n, size_t k)
+ *     有界大顶堆：最小的k个元素移到前k位并构成堆，O(n log k)，要求1<=k<=n
+ *   sort_select_##name(T* base, size_t n, size_t k)
+ *     内省选择：第k个（从0起）元素就位，前面不大于它、后面不小于它；
+ *     快速选择的分区层数超过2log(n)时退回有界堆，要求k<n
+ *   sort_partial_##name(T* base, size_t n, size_t k)
+ *     最小的k个元素按升序放在前k位，其余顺序不定，要求1<=k<=n
+ */
+#define SORT_PARTIAL_HEAP_RATIO 8   /* k不超过n/8时部分排序用有界堆，否则先选择再排前缀 */
+
+#define SORT_DEFINE_SELECT(name, T, LESS)                                      \
+                                                                               \
+static void sort_heap_select_##name(T* base, size_t n, size_t k) {            \
+    for (size_t i = k / 2; i-- > 0; )                                          \
+        sort_sift_down_##name(base, i, k);                                     \
+    for (size_t i = k; i < n; i++) {                                           \
+        if (LESS(&base[i], base)) {                                            \
+            sort_swap_##name(base, &base[i]);                                  \
+            sort_sift_down_##name(base, 0, k);                                 \
+        }                                                                      \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+static void sort_select_##name(T* base, size_t n, size_t k) {                 \
+    int depth = 0;                                                             \
+    for (size_t m = n; m > 1; m >>= 1)                                         \
+        depth += 2;                                                            \
+    while (n > SORT_KERNEL_INSERTION_THRESHOLD) {                              \
+        if (depth-- == 0) {                                                    \
+            sort_heap_select_##name(base, n, k + 1);                           \
+            sort_swap_##name(base, &base[k]);                                  \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        T* lo = base;                                                          \
+        T* mid = base + n / 2;                                                 \
+        T* hi = base + n - 1;                                                  \
+        if (n > 128) {                                                         \
+            size_t step = n / 8;                                               \
+            lo = sort_median3_##name(lo, lo + step, lo + 2 * step);            \
+            mid = sort_median3_##name(mid - step, mid, mid + step);            \
+            hi = sort_median3_##name(hi - 2 * step, hi - step, hi);            \
+        }                                                                      \
+        sort_swap_##name(base, sort_median3_##name(lo, mid, hi));              \
+                                                                               \
+        size_t i = 0, j = n;                                                   \
+        for (;;) {                                                             \
+            while (++i < n && LESS(&base[i], base));                           \
+            while (LESS(base, &base[--j]));                                    \
+            if (i >= j) break;                                                 \
+            sort_swap_##name(&base[i], &base[j]);                              \
+        }                                                                      \
+        sort_swap_##name(base, &base[j]);                                      \
+                                                                               \
+        if (k == j) return;                                                    \
+        if (k < j) {                                                           \
+            n = j;                                                             \
+        } else {                                                               \
+            base += j + 1;                                                     \
+            n -= j + 1;                                                        \
+            k -= j + 1;                                                        \
+        }                                                                      \
+    }                                                                          \
+    sort_insertion_##name(base, n);                                            \
+}                                                                              \
+                                                                               \
+static void sort_partial_##name(T* base, size_t n, size_t k) {                \
+    if (k <= n / SORT_PARTIAL_HEAP_RATIO) {                                    \
+        sort_heap_select_##name(base, n, k);                                   \
+        sort_heap_##name(base, k);                                             \
+        return;                                                                \
+    }                                                                          \
+    if (k < n)                                                                 \
+        sort_select_##name(base, n, k - 1);                                    \
+    sort_intro_##name(base, k);                                                \
+}
+
+#endif /* SORT_KERNELS_H */
@@ -0,0 +1,263 @@
+/* sort_simd.c - AVX2排序网络与双调归并小块排序内核 */
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include "sort_simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORT_SIMD_X86 1
+#include <immintrin.h>
+#define SORT_SIMD_TARGET __attribute__((target("avx2")))
+#endif
+
+/* ===================== 标量回退 ===================== */
+static void insertion_int(int* data, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int v = data[i];
+        size_t j = i;
+        while (j > 0 && v < data[j - 1]) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = v;
+    }
+}
+
+static void insertion_double(double* data, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        double v = data[i];
+        size_t j = i;
+        while (j > 0 && v < data[j - 1]) {
+            data[j] = data[j - 1];
+            j--;
+        }
+        data[j] = v;
+    }
+}
+
+#ifdef SORT_SIMD_X86
+/* 0: 未检测，1: 可用，-1: 不可用；检测结果幂等，并发写入无害 */
+static int simd_state = 0;
+
+int sort_simd_available(void) {
+    if (simd_state == 0) {
+        __builtin_cpu_init();
+        simd_state = __builtin_cpu_supports("avx2") ? 1 : -1;
+    }
+    return simd_state > 0;
+}
+
+/*
+ * 双调排序的每一步：与距离为j的伙伴比较，mask中置位的通道取较大值。
+ * 通道i取较小值当且仅当 (i & j) == 0 与 (i & k) == 0 同真同假。
+ */
+
+/* ===================== int：8通道 ===================== */
+#define SWAP_ADJ_EPI32(v)  _mm256_shuffle_epi32((v), _MM_SHUFFLE(2, 3, 0, 1))
+#define SWAP_PAIR_EPI32(v) _mm256_shuffle_epi32((v), _MM_SHUFFLE(1, 0, 3, 2))
+#define SWAP_HALF_EPI32(v) _mm256_permute2x128_si256((v), (v), 0x01)
+
+#define STEP_EPI32(v, partner, mask) \
+    _mm256_blend_epi32(_mm256_min_epi32((v), (partner)), _mm256_max_epi32((v), (partner)), (mask))
+
+/* 双调序列 -> 升序 */
+static inline SORT_SIMD_TARGET __m256i clean8_epi32(__m256i v) {
+    v = STEP_EPI32(v, SWAP_HALF_EPI32(v), 0xF0);
+    v = STEP_EPI32(v, SWAP_PAIR_EPI32(v), 0xCC);
+    v = STEP_EPI32(v, SWAP_ADJ_EPI32(v), 0xAA);
+    return v;
+}
+
+/* 寄存器内8元素双调排序网络 */
+static inline SORT_SIMD_TARGET __m256i sort8_epi32(__m256i v) {
+    v = STEP_EPI32(v, SWAP_ADJ_EPI32(v), 0x66);
+    v = STEP_EPI32(v, SWAP_PAIR_EPI32(v), 0x3C);
+    v = STEP_EPI32(v, SWAP_ADJ_EPI32(v), 0x5A);
+    return clean8_epi32(v);
+}
+
+static inline SORT_SIMD_TARGET __m256i reverse8_epi32(__m256i v) {
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+/* 合并两个升序8元组，*a得到较小的8个，*b得到较大的8个 */
+static inline SORT_SIMD_TARGET void merge8_epi32(__m256i* a, __m256i* b) {
+    __m256i r = reverse8_epi32(*b);
+    __m256i lo = _mm256_min_epi32(*a, r);
+    __m256i hi = _mm256_max_epi32(*a, r);
+    *a = clean8_epi32(lo);
+    *b = clean8_epi32(hi);
+}
+
+/* 合并两个升序16元组(a0,a1)与(b0,b1) */
+static inline SORT_SIMD_TARGET void merge16_epi32(__m256i* a0, __m256i* a1,
+                                                  __m256i* b0, __m256i* b1) {
+    __m256i r0 = reverse8_epi32(*b1);
+    __m256i r1 = reverse8_epi32(*b0);
+    __m256i l0 = _mm256_min_epi32(*a0, r0), h0 = _mm256_max_epi32(*a0, r0);
+    __m256i l1 = _mm256_min_epi32(*a1, r1), h1 = _mm256_max_epi32(*a1, r1);
+
+    // 两个双调16元组分别清理：先跨寄存器比较，再各自寄存器内清理
+    *a0 = clean8_epi32(_mm256_min_epi32(l0, l1));
+    *a1 = clean8_epi32(_mm256_max_epi32(l0, l1));
+    *b0 = clean8_epi32(_mm256_min_epi32(h0, h1));
+    *b1 = clean8_epi32(_mm256_max_epi32(h0, h1));
+}
+
+static SORT_SIMD_TARGET void small_int_avx2(int* data, size_t n) {
+    // 不足一块的部分用INT_MAX填充，排序后只取前n个
+    int buf[SORT_SIMD_INT_BLOCK];
+    for (size_t i = 0; i < SORT_SIMD_INT_BLOCK; i++)
+        buf[i] = INT_MAX;
+    memcpy(buf, data, n * sizeof(int));
+
+    __m256i v0 = sort8_epi32(_mm256_loadu_si256((const __m256i*)buf));
+    if (n <= 8) {
+        _mm256_storeu_si256((__m256i*)buf, v0);
+    } else {
+        __m256i v1 = sort8_epi32(_mm256_loadu_si256((const __m256i*)(buf + 8)));
+        merge8_epi32(&v0, &v1);
+        if (n <= 16) {
+            _mm256_storeu_si256((__m256i*)buf, v0);
+            _mm256_storeu_si256((__m256i*)(buf + 8), v1);
+        } else {
+            __m256i v2 = sort8_epi32(_mm256_loadu_si256((const __m256i*)(buf + 16)));
+            __m256i v3 = sort8_epi32(_mm256_loadu_si256((const __m256i*)(buf + 24)));
+            merge8_epi32(&v2, &v3);
+            merge16_epi32(&v0, &v1, &v2, &v3);
+            _mm256_storeu_si256((__m256i*)buf, v0);
+            _mm256_storeu_si256((__m256i*)(buf + 8), v1);
+            _mm256_storeu_si256((__m256i*)(buf + 16), v2);
+            _mm256_storeu_si256((__m256i*)(buf + 24), v3);
+        }
+    }
+    memcpy(data, buf, n * sizeof(int));
+}
+
+/* ===================== double：4通道 ===================== */
+#define SWAP_ADJ_PD(v)  _mm256_permute_pd((v), 0x5)
+#define SWAP_HALF_PD(v) _mm256_permute2f128_pd((v), (v), 0x01)
+
+/*
+ * 比较交换不用min_pd/max_pd：两者在操作数相等（+0与-0）或含NaN时都返回第二个操作数，
+ * 会丢失一个值并复制另一个。这里按同一次严格小于比较的结果在两个原操作数之间选择，
+ * 每条通道的输出总是原值之一，网络始终只是重排输入。
+ */
+static inline SORT_SIMD_TARGET void cmpswap_pd(__m256d a, __m256d b, __m256d* lo, __m256d* hi) {
+    __m256d b_less = _mm256_cmp_pd(b, a, _CMP_LT_OQ);
+    *lo = _mm256_blendv_pd(a, b, b_less);
+    *hi = _mm256_blendv_pd(b, a, b_less);
+}
+
+/* v与同一向量内的partner比较交换，mask为1的通道取较大值；成对的两条通道使用同一方向的比较 */
+#define STEP_PD(v, partner, mask)                                                        \
+    _mm256_blend_pd(_mm256_blendv_pd((v), (partner), _mm256_cmp_pd((partner), (v), _CMP_LT_OQ)), \
+                    _mm256_blendv_pd((v), (partner), _mm256_cmp_pd((v), (partner), _CMP_LT_OQ)), \
+                    (mask))
+
+static inline SORT_SIMD_TARGET __m256d clean4_pd(__m256d v) {
+    v = STEP_PD(v, SWAP_HALF_PD(v), 0xC);
+    v = STEP_PD(v, SWAP_ADJ_PD(v), 0xA);
+    return v;
+}
+
+static inline SORT_SIMD_TARGET __m256d sort4_pd(__m256d v) {
+    v = STEP_PD(v, SWAP_ADJ_PD(v), 0x6);
+    return clean4_pd(v);
+}
+
+static inline SORT_SIMD_TARGET __m256d reverse4_pd(__m256d v) {
+    return _mm256_permute4x64_pd(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static inline SORT_SIMD_TARGET void merge4_pd(__m256d* a, __m256d* b) {
+    __m256d r = reverse4_pd(*b);
+    __m256d lo, hi;
+    cmpswap_pd(*a, r, &lo, &hi);
+    *a = clean4_pd(lo);
+    *b = clean4_pd(hi);
+}
+
+static inline SORT_SIMD_TARGET void merge8_pd(__m256d* a0, __m256d* a1,
+                                              __m256d* b0, __m256d* b1) {
+    __m256d r0 = reverse4_pd(*b1);
+    __m256d r1 = reverse4_pd(*b0);
+    __m256d l0, h0, l1, h1;
+    cmpswap_pd(*a0, r0, &l0, &h0);
+    cmpswap_pd(*a1, r1, &l1, &h1);
+
+    cmpswap_pd(l0, l1, a0, a1);
+    cmpswap_pd(h0, h1, b0, b1);
+    *a0 = clean4_pd(*a0);
+    *a1 = clean4_pd(*a1);
+    *b0 = clean4_pd(*b0);
+    *b1 = clean4_pd(*b1);
+}
+
+static SORT_SIMD_TARGET void small_double_avx2(double* data, size_t n) {
+    double buf[SORT_SIMD_DOUBLE_BLOCK];
+    for (size_t i = 0; i < SORT_SIMD_DOUBLE_BLOCK; i++)
+        buf[i] = HUGE_VAL;
+    memcpy(buf, data, n * sizeof(double));
+
+    __m256d v0 = sort4_pd(_mm256_loadu_pd(buf));
+    if (n <= 4) {
+        _mm256_storeu_pd(buf, v0);
+    } else {
+        __m256d v1 = sort4_pd(_mm256_loadu_pd(buf + 4));
+        merge4_pd(&v0, &v1);
+        if (n <= 8) {
+            _mm256_storeu_pd(buf, v0);
+            _mm256_storeu_pd(buf + 4, v1);
+        } else {
+            __m256d v2 = sort4_pd(_mm256_loadu_pd(buf + 8));
+            __m256d v3 = sort4_pd(_mm256_loadu_pd(buf + 12));
+            merge4_pd(&v2, &v3);
+            merge8_pd(&v0, &v1, &v2, &v3);
+            _mm256_storeu_pd(buf, v0);
+            _mm256_storeu_pd(buf + 4, v1);
+            _mm256_storeu_pd(buf + 8, v2);
+            _mm256_storeu_pd(buf + 12, v3);
+        }
+    }
+    memcpy(data, buf, n * sizeof(double));
+}
+
+void sort_simd_small_int(int* data, size_t n) {
+    if (n < 2) return;
+    if (sort_simd_available())
+        small_int_avx2(data, n);
+    else
+        insertion_int(data, n);
+}
+
+/* NaN与任何值比较都为假，可能留在HUGE_VAL填充之后被截掉，含NaN的块交给插入排序 */
+static int has_nan(const double* data, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        if (isnan(data[i])) return 1;
+    return 0;
+}
+
+void sort_simd_small_double(double* data, size_t n) {
+    if (n < 2) return;
+    if (sort_simd_available() && !has_nan(data, n))
+        small_double_avx2(data, n);
+    else
+        insertion_double(data, n);
+}
+
+#else /* 非x86或非GCC兼容编译器：仅标量实现 */
+
+int sort_simd_available(void) {
+    return 0;
+}
+
+void sort_simd_small_int(int* data, size_t n) {
+    insertion_int(data, n);
+}
+
+void sort_simd_small_double(double* data, size_t n) {
+    insertion_double(data, n);
+}
+
+#endif
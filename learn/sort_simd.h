@@ -0,0 +1,22 @@
+/* sort_simd.h - AVX2排序网络与双调归并小块排序内核 */
+#ifndef SORT_SIMD_H
+#define SORT_SIMD_H
+
+#include <stddef.h>
+
+/* 单次调用可处理的最大元素数 */
+#define SORT_SIMD_INT_BLOCK 32
+#define SORT_SIMD_DOUBLE_BLOCK 16
+
+/* 运行期检测CPU是否支持AVX2，非0表示可用 */
+int sort_simd_available(void);
+
+/*
+ * 小块排序：n不超过对应的BLOCK常量。
+ * 支持AVX2时在寄存器内完成排序网络与双调归并，否则退回标量插入排序。
+ * 排序网络只重排输入：+0与-0按相等处理，各自保留；含NaN的块退回插入排序。
+ */
+void sort_simd_small_int(int* data, size_t n);
+void sort_simd_small_double(double* data, size_t n);
+
+#endif /* SORT_SIMD_H */
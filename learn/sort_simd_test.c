@@ -0,0 +1,76 @@
+/* sort_simd_test.c - 验证小块排序内核只重排输入：make sort_simd_test && ./sort_simd_test */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sort_simd.h"
+
+#define ROUNDS 200000
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* 偏重NaN、正负零、无穷与重复值，其余为普通随机数 */
+static double random_value(void) {
+    switch (next_random() % 8) {
+    case 0: return NAN;
+    case 1: return 0.0;
+    case 2: return -0.0;
+    case 3: return (next_random() & 1) ? HUGE_VAL : -HUGE_VAL;
+    case 4: return (double)(next_random() % 5);
+    default: return (double)(next_random() >> 11) * 0x1p-40 - 4096.0;
+    }
+}
+
+/* 按位模式比较，NaN与正负零都能区分 */
+static int compare_bits(const void* a, const void* b) {
+    uint64_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return x < y ? -1 : x > y;
+}
+
+static int same_multiset(const double* a, const double* b, size_t n) {
+    double x[SORT_SIMD_DOUBLE_BLOCK], y[SORT_SIMD_DOUBLE_BLOCK];
+    memcpy(x, a, n * sizeof(double));
+    memcpy(y, b, n * sizeof(double));
+    qsort(x, n, sizeof(double), compare_bits);
+    qsort(y, n, sizeof(double), compare_bits);
+    return memcmp(x, y, n * sizeof(double)) == 0;
+}
+
+int main(void) {
+    int failures = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        double input[SORT_SIMD_DOUBLE_BLOCK], output[SORT_SIMD_DOUBLE_BLOCK];
+        size_t n = 1 + next_random() % SORT_SIMD_DOUBLE_BLOCK;
+        int allow_nan = round % 2, has_nan = 0;
+        for (size_t i = 0; i < n; i++) {
+            do input[i] = random_value(); while (!allow_nan && isnan(input[i]));
+            has_nan |= isnan(input[i]) != 0;
+        }
+        memcpy(output, input, n * sizeof(double));
+        sort_simd_small_double(output, n);
+
+        int ok = same_multiset(input, output, n);
+        for (size_t i = 1; ok && !has_nan && i < n; i++)
+            ok = !(output[i] < output[i - 1]);
+        if (!ok && failures++ < 5) {
+            printf("失败: n=%zu 输入:", n);
+            for (size_t i = 0; i < n; i++) printf(" %g", input[i]);
+            printf("\n      输出:");
+            for (size_t i = 0; i < n; i++) printf(" %g", output[i]);
+            printf("\n");
+        }
+    }
+    printf("double小块排序(%s): %d轮, %d次失败\n",
+           sort_simd_available() ? "AVX2" : "标量", ROUNDS, failures);
+    return failures != 0;
+}
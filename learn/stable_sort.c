@@ -0,0 +1,434 @@
+/* stable_sort.c - 利用已有顺串的稳定自适应归并排序（TimSort风格） */
+#include <stdlib.h>
+#include <string.h>
+#include "stable_sort.h"
+
+/* 短于该长度的输入直接二分插入排序 */
+#define STABLE_MIN_MERGE 64
+/* 一侧连续胜出该次数后进入倍增查找模式，随命中情况自适应调整 */
+#define STABLE_MIN_GALLOP 7
+/* 顺串栈深度：栈不变式保证长度至少按斐波那契增长，85层足以覆盖64位下标 */
+#define STABLE_MAX_RUNS 85
+
+#define STABLE_ELEM(base, i, size) ((char*)(base) + (size_t)(i) * (size))
+
+typedef struct {
+    size_t start;
+    size_t len;
+} StableRun;
+
+typedef struct {
+    char* base;
+    size_t size;
+    int (*compar)(const void*, const void*);
+    char* tmp;                   /* 归并缓冲区，至少容纳较短一侧的顺串 */
+    size_t min_gallop;
+    StableRun runs[STABLE_MAX_RUNS];
+    int nruns;
+} StableState;
+
+void stable_sort_buffer_free(StableSortBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->bytes = 0;
+}
+
+/* 最小顺串长度：取n的高6位，低位有1时加1，使顺串数接近2的幂 */
+static size_t stable_min_run(size_t n) {
+    size_t r = 0;
+    while (n >= STABLE_MIN_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+static void stable_reverse(char* lo, char* hi, size_t size) {
+    char tmp[size];
+    for (hi -= size; lo < hi; lo += size, hi -= size) {
+        memcpy(tmp, lo, size);
+        memcpy(lo, hi, size);
+        memcpy(hi, tmp, size);
+    }
+}
+
+/* [lo, lo+start)已有序，把其后直到n的元素逐个二分插入；相等元素插在已有元素之后以保持稳定 */
+static void stable_binary_insertion(const StableState* st, char* lo, size_t n, size_t start) {
+    size_t size = st->size;
+    char pivot[size];
+    for (size_t i = start ? start : 1; i < n; i++) {
+        memcpy(pivot, STABLE_ELEM(lo, i, size), size);
+        size_t left = 0, right = i;
+        while (left < right) {
+            size_t mid = left + (right - left) / 2;
+            if (st->compar(pivot, STABLE_ELEM(lo, mid, size)) < 0) right = mid;
+            else left = mid + 1;
+        }
+        memmove(STABLE_ELEM(lo, left + 1, size), STABLE_ELEM(lo, left, size), (i - left) * size);
+        memcpy(STABLE_ELEM(lo, left, size), pivot, size);
+    }
+}
+
+/* 从lo开始的顺串长度：非降序直接计入，严格降序翻转为升序（严格保证翻转不破坏稳定性） */
+static size_t stable_count_run(const StableState* st, char* lo, size_t n) {
+    size_t size = st->size;
+    if (n < 2) return n;
+    size_t len = 2;
+    if (st->compar(STABLE_ELEM(lo, 1, size), lo) < 0) {
+        while (len < n && st->compar(STABLE_ELEM(lo, len, size), STABLE_ELEM(lo, len - 1, size)) < 0)
+            len++;
+        stable_reverse(lo, STABLE_ELEM(lo, len, size), size);
+    } else {
+        while (len < n && st->compar(STABLE_ELEM(lo, len, size), STABLE_ELEM(lo, len - 1, size)) >= 0)
+            len++;
+    }
+    return len;
+}
+
+/*
+ * 在有序数组a[0, n)中从hint处倍增再二分，返回key的最左插入位置k：
+ * a[k-1] < key <= a[k]。下标可能暂时为-1，用带符号类型。
+ */
+static size_t stable_gallop_left(const StableState* st, const char* key, const char* a,
+                                 size_t n, size_t hint) {
+    size_t size = st->size;
+    ptrdiff_t ofs = 1, lastofs = 0, h = (ptrdiff_t)hint;
+    if (st->compar(STABLE_ELEM(a, h, size), key) < 0) {
+        /* a[h] < key：向右倍增，直到a[h+lastofs] < key <= a[h+ofs] */
+        ptrdiff_t maxofs = (ptrdiff_t)n - h;
+        while (ofs < maxofs && st->compar(STABLE_ELEM(a, h + ofs, size), key) < 0) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) ofs = maxofs;
+        lastofs += h;
+        ofs += h;
+    } else {
+        /* key <= a[h]：向左倍增，直到a[h-ofs] < key <= a[h-lastofs] */
+        ptrdiff_t maxofs = h + 1;
+        while (ofs < maxofs && st->compar(STABLE_ELEM(a, h - ofs, size), key) >= 0) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) ofs = maxofs;
+        ptrdiff_t t = lastofs;
+        lastofs = h - ofs;
+        ofs = h - t;
+    }
+    /* a[lastofs] < key <= a[ofs]，在(lastofs, ofs]内二分 */
+    lastofs++;
+    while (lastofs < ofs) {
+        ptrdiff_t mid = lastofs + ((ofs - lastofs) >> 1);
+        if (st->compar(STABLE_ELEM(a, mid, size), key) < 0) lastofs = mid + 1;
+        else ofs = mid;
+    }
+    return (size_t)ofs;
+}
+
+/* 同上，返回最右插入位置k：a[k-1] <= key < a[k] */
+static size_t stable_gallop_right(const StableState* st, const char* key, const char* a,
+                                  size_t n, size_t hint) {
+    size_t size = st->size;
+    ptrdiff_t ofs = 1, lastofs = 0, h = (ptrdiff_t)hint;
+    if (st->compar(key, STABLE_ELEM(a, h, size)) < 0) {
+        /* key < a[h]：向左倍增，直到a[h-ofs] <= key < a[h-lastofs] */
+        ptrdiff_t maxofs = h + 1;
+        while (ofs < maxofs && st->compar(key, STABLE_ELEM(a, h - ofs, size)) < 0) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) ofs = maxofs;
+        ptrdiff_t t = lastofs;
+        lastofs = h - ofs;
+        ofs = h - t;
+    } else {
+        /* a[h] <= key：向右倍增，直到a[h+lastofs] <= key < a[h+ofs] */
+        ptrdiff_t maxofs = (ptrdiff_t)n - h;
+        while (ofs < maxofs && st->compar(key, STABLE_ELEM(a, h + ofs, size)) >= 0) {
+            lastofs = ofs;
+            ofs = (ofs << 1) + 1;
+        }
+        if (ofs > maxofs) ofs = maxofs;
+        lastofs += h;
+        ofs += h;
+    }
+    lastofs++;
+    while (lastofs < ofs) {
+        ptrdiff_t mid = lastofs + ((ofs - lastofs) >> 1);
+        if (st->compar(key, STABLE_ELEM(a, mid, size)) < 0) ofs = mid;
+        else lastofs = mid + 1;
+    }
+    return (size_t)ofs;
+}
+
+/*
+ * 左侧较短：A复制到缓冲区，从左向右写回。
+ * 调用前已保证B[0] < A[0]且A[na-1] > B[nb-1]，因此B[0]先出、A的末元素最后出。
+ */
+static void stable_merge_lo(StableState* st, char* pa, size_t na, char* pb, size_t nb) {
+    size_t size = st->size;
+    size_t min_gallop = st->min_gallop;
+    char* dest = pa;
+    memcpy(st->tmp, pa, na * size);
+    pa = st->tmp;
+
+    memcpy(dest, pb, size);
+    dest += size;
+    pb += size;
+    if (--nb == 0) goto done;
+    if (na == 1) goto copy_b;
+
+    for (;;) {
+        size_t acount = 0, bcount = 0;
+        /* 逐个比较，直到一侧连续胜出min_gallop次 */
+        for (;;) {
+            if (st->compar(pb, pa) < 0) {
+                memcpy(dest, pb, size);
+                dest += size;
+                pb += size;
+                bcount++;
+                acount = 0;
+                if (--nb == 0) goto done;
+                if (bcount >= min_gallop) break;
+            } else {
+                memcpy(dest, pa, size);
+                dest += size;
+                pa += size;
+                acount++;
+                bcount = 0;
+                if (--na == 1) goto copy_b;
+                if (acount >= min_gallop) break;
+            }
+        }
+
+        /* 倍增查找模式：整块搬运一侧中不需要比较的元素，命中越多门槛越低 */
+        min_gallop++;
+        do {
+            min_gallop -= min_gallop > 1;
+            st->min_gallop = min_gallop;
+            acount = stable_gallop_right(st, pb, pa, na, 0);
+            if (acount) {
+                memcpy(dest, pa, acount * size);
+                dest += acount * size;
+                pa += acount * size;
+                na -= acount;
+                if (na == 1) goto copy_b;
+                if (na == 0) goto done;  /* 仅在比较函数不一致时发生 */
+            }
+            memcpy(dest, pb, size);
+            dest += size;
+            pb += size;
+            if (--nb == 0) goto done;
+
+            bcount = stable_gallop_left(st, pa, pb, nb, 0);
+            if (bcount) {
+                memmove(dest, pb, bcount * size);
+                dest += bcount * size;
+                pb += bcount * size;
+                nb -= bcount;
+                if (nb == 0) goto done;
+            }
+            memcpy(dest, pa, size);
+            dest += size;
+            pa += size;
+            if (--na == 1) goto copy_b;
+        } while (acount >= STABLE_MIN_GALLOP || bcount >= STABLE_MIN_GALLOP);
+        min_gallop++;
+        st->min_gallop = min_gallop;
+    }
+
+done:
+    if (na) memcpy(dest, pa, na * size);
+    return;
+copy_b:
+    /* A只剩末元素，它大于B剩余的全部元素 */
+    memmove(dest, pb, nb * size);
+    memcpy(dest + nb * size, pa, size);
+}
+
+/* 右侧较短：B复制到缓冲区，从右向左写回；前置条件同stable_merge_lo */
+static void stable_merge_hi(StableState* st, char* pa, size_t na, char* pb, size_t nb) {
+    size_t size = st->size;
+    size_t min_gallop = st->min_gallop;
+    char* base_a = pa;
+    char* base_b = st->tmp;
+    char* dest = pb + (nb - 1) * size;
+    memcpy(base_b, pb, nb * size);
+    pb = base_b + (nb - 1) * size;
+    pa += (na - 1) * size;
+
+    memcpy(dest, pa, size);
+    dest -= size;
+    pa -= size;
+    if (--na == 0) goto done;
+    if (nb == 1) goto copy_a;
+
+    for (;;) {
+        size_t acount = 0, bcount = 0;
+        for (;;) {
+            if (st->compar(pb, pa) < 0) {
+                memcpy(dest, pa, size);
+                dest -= size;
+                pa -= size;
+                acount++;
+                bcount = 0;
+                if (--na == 0) goto done;
+                if (acount >= min_gallop) break;
+            } else {
+                memcpy(dest, pb, size);
+                dest -= size;
+                pb -= size;
+                bcount++;
+                acount = 0;
+                if (--nb == 1) goto copy_a;
+                if (bcount >= min_gallop) break;
+            }
+        }
+
+        min_gallop++;
+        do {
+            min_gallop -= min_gallop > 1;
+            st->min_gallop = min_gallop;
+            acount = na - stable_gallop_right(st, pb, base_a, na, na - 1);
+            if (acount) {
+                dest -= acount * size;
+                pa -= acount * size;
+                memmove(dest + size, pa + size, acount * size);
+                na -= acount;
+                if (na == 0) goto done;
+            }
+            memcpy(dest, pb, size);
+            dest -= size;
+            pb -= size;
+            if (--nb == 1) goto copy_a;
+
+            bcount = nb - stable_gallop_left(st, pa, base_b, nb, nb - 1);
+            if (bcount) {
+                dest -= bcount * size;
+                pb -= bcount * size;
+                memcpy(dest + size, pb + size, bcount * size);
+                nb -= bcount;
+                if (nb == 1) goto copy_a;
+                if (nb == 0) goto done;  /* 仅在比较函数不一致时发生 */
+            }
+            memcpy(dest, pa, size);
+            dest -= size;
+            pa -= size;
+            if (--na == 0) goto done;
+        } while (acount >= STABLE_MIN_GALLOP || bcount >= STABLE_MIN_GALLOP);
+        min_gallop++;
+        st->min_gallop = min_gallop;
+    }
+
+done:
+    if (nb) memcpy(dest - (nb - 1) * size, base_b, nb * size);
+    return;
+copy_a:
+    /* B只剩首元素，它小于A剩余的全部元素 */
+    dest -= na * size;
+    pa -= na * size;
+    memmove(dest + size, pa + size, na * size);
+    memcpy(dest, pb, size);
+}
+
+/* 归并栈上第i与i+1个顺串 */
+static void stable_merge_at(StableState* st, int i) {
+    size_t size = st->size;
+    StableRun* a = &st->runs[i];
+    StableRun* b = &st->runs[i + 1];
+    char* pa = STABLE_ELEM(st->base, a->start, size);
+    char* pb = STABLE_ELEM(st->base, b->start, size);
+    size_t na = a->len, nb = b->len;
+
+    a->len += nb;
+    if (i == st->nruns - 3) st->runs[i + 1] = st->runs[i + 2];
+    st->nruns--;
+
+    /* A中不大于B[0]的前缀与B中不小于A末元素的后缀已经就位 */
+    size_t k = stable_gallop_right(st, pb, pa, na, 0);
+    pa += k * size;
+    na -= k;
+    if (na == 0) return;
+    nb = stable_gallop_left(st, STABLE_ELEM(pa, na - 1, size), pb, nb, nb - 1);
+    if (nb == 0) return;
+
+    if (na <= nb) stable_merge_lo(st, pa, na, pb, nb);
+    else stable_merge_hi(st, pa, na, pb, nb);
+}
+
+/* 维持栈不变式：len[i-2] > len[i-1] + len[i] 且 len[i-1] > len[i]（含对第4层的检查） */
+static void stable_merge_collapse(StableState* st) {
+    StableRun* r = st->runs;
+    while (st->nruns > 1) {
+        int n = st->nruns - 2;
+        if ((n > 0 && r[n - 1].len <= r[n].len + r[n + 1].len) ||
+            (n > 1 && r[n - 2].len <= r[n - 1].len + r[n].len)) {
+            if (r[n - 1].len < r[n + 1].len) n--;
+            stable_merge_at(st, n);
+        } else if (r[n].len <= r[n + 1].len) {
+            stable_merge_at(st, n);
+        } else {
+            break;
+        }
+    }
+}
+
+static void stable_merge_force(StableState* st) {
+    StableRun* r = st->runs;
+    while (st->nruns > 1) {
+        int n = st->nruns - 2;
+        if (n > 0 && r[n - 1].len < r[n + 1].len) n--;
+        stable_merge_at(st, n);
+    }
+}
+
+int stable_sort(void* base, size_t nmemb, size_t size,
+                int (*compar)(const void*, const void*), StableSortBuffer* buffer) {
+    StableState st;
+    StableSortBuffer local = { NULL, 0 };
+    if (nmemb < 2 || size == 0) return 0;
+
+    st.base = base;
+    st.size = size;
+    st.compar = compar;
+    st.min_gallop = STABLE_MIN_GALLOP;
+    st.nruns = 0;
+
+    if (nmemb < STABLE_MIN_MERGE) {
+        stable_binary_insertion(&st, st.base, nmemb, stable_count_run(&st, st.base, nmemb));
+        return 0;
+    }
+
+    /* 归并时较短一侧不超过nmemb/2个元素，先一次备好缓冲区，失败时不动数据 */
+    if (!buffer) buffer = &local;
+    size_t need = (nmemb / 2) * size;
+    if (buffer->bytes < need) {
+        void* data = realloc(buffer->data, need);
+        if (!data) return -1;
+        buffer->data = data;
+        buffer->bytes = need;
+    }
+    st.tmp = buffer->data;
+
+    size_t min_run = stable_min_run(nmemb);
+    size_t lo = 0;
+    while (lo < nmemb) {
+        char* start = STABLE_ELEM(base, lo, size);
+        size_t remaining = nmemb - lo;
+        size_t len = stable_count_run(&st, start, remaining);
+        if (len < min_run) {
+            size_t forced = remaining < min_run ? remaining : min_run;
+            stable_binary_insertion(&st, start, forced, len);
+            len = forced;
+        }
+        st.runs[st.nruns].start = lo;
+        st.runs[st.nruns].len = len;
+        st.nruns++;
+        stable_merge_collapse(&st);
+        lo += len;
+    }
+    stable_merge_force(&st);
+
+    if (buffer == &local) stable_sort_buffer_free(&local);
+    return 0;
+}
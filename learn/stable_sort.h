@@ -0,0 +1,24 @@
+/* stable_sort.h - 利用已有顺串的稳定自适应归并排序（TimSort风格） */
+#ifndef STABLE_SORT_H
+#define STABLE_SORT_H
+
+#include <stddef.h>
+
+/* 可复用的归并缓冲区，零初始化即可使用；排序时按需扩容，跨次调用保留 */
+typedef struct {
+    void* data;
+    size_t bytes;
+} StableSortBuffer;
+
+void stable_sort_buffer_free(StableSortBuffer* buffer);
+
+/*
+ * 稳定排序：识别自然升序/严格降序顺串（降序原地翻转），短顺串用二分插入补到最小长度，
+ * 按栈不变式归并相邻顺串，归并中一侧连续胜出时切换为倍增查找整块搬运。
+ * 已有序或追加为主的输入接近线性。buffer为NULL时使用临时缓冲区。
+ * 成功返回0；归并缓冲区（至多nmemb/2个元素）分配失败返回-1，此时base内容未被修改。
+ */
+int stable_sort(void* base, size_t nmemb, size_t size,
+                int (*compar)(const void*, const void*), StableSortBuffer* buffer);
+
+#endif /* STABLE_SORT_H */
@@ -0,0 +1,113 @@
+/* string_pool.c - 连续字符串池与带前缀缓存的字符串条目 */
+#include <stdlib.h>
+#include <string.h>
+#include "string_pool.h"
+#include "sort_kernels.h"
+
+#define POOL_PREFIX_BYTES 8
+
+/* 从depth开始取最多8字节，按大端序打包，超出字符串末尾的部分为0 */
+static uint64_t pool_pack(const char* str, size_t len, size_t depth) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < POOL_PREFIX_BYTES; i++) {
+        size_t pos = depth + i;
+        key = (key << 8) | (pos < len ? (unsigned char)str[pos] : 0);
+    }
+    return key;
+}
+
+int string_pool_init(StringPool* pool, size_t capacity) {
+    pool->bytes = capacity ? malloc(capacity) : NULL;
+    pool->used = 0;
+    pool->capacity = pool->bytes ? capacity : 0;
+    return (capacity && !pool->bytes) ? -1 : 0;
+}
+
+void string_pool_free(StringPool* pool) {
+    free(pool->bytes);
+    pool->bytes = NULL;
+    pool->used = 0;
+    pool->capacity = 0;
+}
+
+void string_pool_clear(StringPool* pool) {
+    pool->used = 0;
+}
+
+int string_pool_add(StringPool* pool, const char* str, size_t len, StringPoolEntry* entry) {
+    size_t need = pool->used + len + 1;
+    if (need > UINT32_MAX) return -1;
+
+    if (need > pool->capacity) {
+        size_t new_cap = pool->capacity ? pool->capacity * 2 : 4096;
+        while (new_cap < need) new_cap *= 2;
+        char* bytes = realloc(pool->bytes, new_cap);
+        if (!bytes) return -1;
+        pool->bytes = bytes;
+        pool->capacity = new_cap;
+    }
+
+    memcpy(pool->bytes + pool->used, str, len);
+    pool->bytes[pool->used + len] = '\0';
+    entry->prefix = pool_pack(str, len, 0);
+    entry->offset = (uint32_t)pool->used;
+    entry->length = (uint32_t)len;
+    pool->used = need;
+    return 0;
+}
+
+int string_pool_compare(const StringPool* pool, const StringPoolEntry* a, const StringPoolEntry* b) {
+    if (a->prefix != b->prefix)
+        return a->prefix < b->prefix ? -1 : 1;
+    // 前缀相同：较短一方若已在前缀内结束，则它是另一方的前缀
+    if (a->length > POOL_PREFIX_BYTES && b->length > POOL_PREFIX_BYTES) {
+        size_t n = (a->length < b->length ? a->length : b->length) - POOL_PREFIX_BYTES;
+        int c = memcmp(string_pool_str(pool, a) + POOL_PREFIX_BYTES,
+                       string_pool_str(pool, b) + POOL_PREFIX_BYTES, n);
+        if (c != 0) return c;
+    }
+    return (a->length > b->length) - (a->length < b->length);
+}
+
+#define POOL_PREFIX_LESS(a, b) ((a)->prefix < (b)->prefix)
+
+SORT_DEFINE_KERNELS(pool_entry, StringPoolEntry, POOL_PREFIX_LESS)
+
+static void pool_sort_tail(const StringPool* pool, StringPoolEntry* e, size_t n, size_t depth);
+
+/* 条目已按[0, depth)字节排好；对这些字节完全相同且仍有更长字符串的区间继续细分 */
+static void pool_refine_runs(const StringPool* pool, StringPoolEntry* e, size_t n, size_t depth) {
+    for (size_t i = 0; i < n; ) {
+        size_t j = i + 1;
+        int longer = e[i].length > depth;
+        while (j < n && e[j].prefix == e[i].prefix) {
+            longer |= e[j].length > depth;
+            j++;
+        }
+        if (j - i > 1 && longer)
+            pool_sort_tail(pool, e + i, j - i, depth);
+        i = j;
+    }
+}
+
+/*
+ * 区间内条目的[0, depth)字节全部相同。临时把prefix换成depth处的8字节分块
+ * 排序并继续细分，最后恢复原前缀（区间内原前缀彼此相同）。
+ */
+static void pool_sort_tail(const StringPool* pool, StringPoolEntry* e, size_t n, size_t depth) {
+    uint64_t saved = e[0].prefix;
+    for (size_t i = 0; i < n; i++)
+        e[i].prefix = pool_pack(string_pool_str(pool, &e[i]), e[i].length, depth);
+    sort_intro_pool_entry(e, n);
+    pool_refine_runs(pool, e, n, depth + POOL_PREFIX_BYTES);
+
+    for (size_t i = 0; i < n; i++)
+        e[i].prefix = saved;
+}
+
+void string_pool_sort(const StringPool* pool, StringPoolEntry* entries, size_t n) {
+    if (n < 2) return;
+    // 多数条目只靠内联前缀就能排好，只有前8字节相同的区间才读取池内字节
+    sort_intro_pool_entry(entries, n);
+    pool_refine_runs(pool, entries, n, POOL_PREFIX_BYTES);
+}
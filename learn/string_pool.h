@@ -0,0 +1,41 @@
+/* string_pool.h - 连续字符串池与带前缀缓存的字符串条目 */
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* 字符串条目：前8字节按大端序打包在prefix中（不足补0），
+ * 多数比较只看prefix即可决定，无需访问池内字节 */
+typedef struct {
+    uint64_t prefix;
+    uint32_t offset;   /* 在池中的起始偏移 */
+    uint32_t length;   /* 不含结尾'\0' */
+} StringPoolEntry;
+
+/* 字符串池：所有字节（含结尾'\0'）连续存放在一块缓冲区中 */
+typedef struct {
+    char* bytes;
+    size_t used;
+    size_t capacity;
+} StringPool;
+
+int string_pool_init(StringPool* pool, size_t capacity);
+void string_pool_free(StringPool* pool);
+/* 清空内容但保留缓冲区，便于重复装载 */
+void string_pool_clear(StringPool* pool);
+
+/* 追加长度为len的字符串并生成条目；池超过4GB或内存不足时返回-1 */
+int string_pool_add(StringPool* pool, const char* str, size_t len, StringPoolEntry* entry);
+
+static inline const char* string_pool_str(const StringPool* pool, const StringPoolEntry* entry) {
+    return pool->bytes + entry->offset;
+}
+
+/* 与strcmp同序的三路比较（字符串不含'\0'） */
+int string_pool_compare(const StringPool* pool, const StringPoolEntry* a, const StringPoolEntry* b);
+
+/* 按字符串顺序排序条目：按8字节分块做MSD，只对前缀相同的条目读取池内后续字节 */
+void string_pool_sort(const StringPool* pool, StringPoolEntry* entries, size_t n);
+
+#endif /* STRING_POOL_H */
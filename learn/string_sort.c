@@ -0,0 +1,120 @@
+/* string_sort.c - 字符串专用排序（MSD基数排序 + 多键快速排序） */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "string_sort.h"
+
+/* 小于该长度的桶改用多键快速排序 */
+#define STRING_RADIX_THRESHOLD 128
+/* 小于该长度的分区改用插入排序 */
+#define STRING_INSERTION_THRESHOLD 12
+
+#define CHAR_AT(s, d) ((unsigned char)(s)[d])
+
+/* 所有字符串前depth个字符已知相同，从depth开始比较 */
+static void string_insertion(char** a, size_t n, size_t depth) {
+    for (size_t i = 1; i < n; i++) {
+        char* v = a[i];
+        size_t j = i;
+        while (j > 0 && strcmp(a[j - 1] + depth, v + depth) > 0) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+static inline void string_swap(char** a, size_t i, size_t j) {
+    char* t = a[i];
+    a[i] = a[j];
+    a[j] = t;
+}
+
+static inline int median3_char(int x, int y, int z) {
+    if (x < y) return y < z ? y : (x < z ? z : x);
+    return x < z ? x : (y < z ? z : y);
+}
+
+/* 多键快速排序：按depth位字符三路划分，等于枢轴的部分进入下一字符位 */
+static void string_mkqsort(char** a, size_t n, size_t depth) {
+    while (n > STRING_INSERTION_THRESHOLD) {
+        int pivot = median3_char(CHAR_AT(a[0], depth), CHAR_AT(a[n / 2], depth),
+                                 CHAR_AT(a[n - 1], depth));
+
+        // Dijkstra三路划分：[0,lt) < pivot，[lt,i) == pivot，(gt,n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            int c = CHAR_AT(a[i], depth);
+            if (c < pivot)
+                string_swap(a, lt++, i++);
+            else if (c > pivot)
+                string_swap(a, i, --gt);
+            else
+                i++;
+        }
+
+        string_mkqsort(a, lt, depth);
+        string_mkqsort(a + gt, n - gt, depth);
+        // 枢轴为字符串结尾时中间部分完全相等
+        if (pivot == 0) return;
+        a += lt;
+        n = gt - lt;
+        depth++;
+    }
+    string_insertion(a, n, depth);
+}
+
+/* MSD基数排序：chars缓存当前位字符，避免二次解引用；tmp为分发用临时数组 */
+static void string_msd(char** a, char** tmp, uint8_t* chars, size_t n, size_t depth) {
+    while (n >= STRING_RADIX_THRESHOLD) {
+        size_t count[256] = {0};
+        for (size_t i = 0; i < n; i++) {
+            chars[i] = CHAR_AT(a[i], depth);
+            count[chars[i]]++;
+        }
+
+        // 所有字符串在该位相同，直接进入下一位
+        if (count[chars[0]] == n) {
+            if (chars[0] == 0) return;
+            depth++;
+            continue;
+        }
+
+        size_t start[256];
+        size_t sum = 0;
+        for (int c = 0; c < 256; c++) {
+            start[c] = sum;
+            sum += count[c];
+        }
+        for (size_t i = 0; i < n; i++)
+            tmp[start[chars[i]]++] = a[i];
+        memcpy(a, tmp, n * sizeof(char*));
+
+        // 桶0是已经结束的字符串，彼此相等；其余桶递归到下一位
+        size_t pos = count[0];
+        for (int c = 1; c < 256; c++) {
+            if (count[c] > 1)
+                string_msd(a + pos, tmp, chars, count[c], depth + 1);
+            pos += count[c];
+        }
+        return;
+    }
+    string_mkqsort(a, n, depth);
+}
+
+void string_sort(char** strs, size_t n) {
+    if (n < 2) return;
+    if (n < STRING_RADIX_THRESHOLD) {
+        string_mkqsort(strs, n, 0);
+        return;
+    }
+
+    char** tmp = malloc(n * sizeof(char*));
+    uint8_t* chars = malloc(n);
+    if (tmp && chars)
+        string_msd(strs, tmp, chars, n, 0);
+    else
+        string_mkqsort(strs, n, 0);
+    free(tmp);
+    free(chars);
+}
@@ -0,0 +1,15 @@
+/* string_sort.h - 字符串专用排序（MSD基数排序 + 多键快速排序） */
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <stddef.h>
+
+/*
+ * 按strcmp顺序排序字符串指针数组。
+ * 大桶按当前字符位做MSD基数分发，小桶改用多键快速排序，
+ * 每个元素的每个字符位只被检查常数次，不会反复从首字节重新比较公共前缀。
+ * 临时缓冲区分配失败时整体退回多键快速排序（无需额外内存）。
+ */
+void string_sort(char** strs, size_t n);
+
+#endif /* STRING_SORT_H */
@@ -9,16 +9,64 @@
 #ifndef TEST_DATA_H
 #define TEST_DATA_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 // 测试数据常量定义
-#define TEST_COUNT 100000
+#define TEST_COUNT 100000       // 默认元素个数，运行期可另行指定
 #define MAX_STRING_LEN 20
 #define FRUIT_TYPES 5
 
-// 测试数据声明（在test_data_generator.h中定义）
-extern int int_data[TEST_COUNT];
-extern double double_data[TEST_COUNT];
-extern char char_data[TEST_COUNT];
-extern char string_data[TEST_COUNT][MAX_STRING_LEN];
-extern TestData struct_data[TEST_COUNT];
+// 输入分布
+typedef enum {
+    DIST_RANDOM,         // 均匀随机
+    DIST_SORTED,         // 升序
+    DIST_REVERSE,        // 降序
+    DIST_NEARLY_SORTED,  // 升序后随机交换k对
+    DIST_ORGAN_PIPE,     // 前半升序、后半降序
+    DIST_FEW_UNIQUE,     // 少数几种取值，随机排列
+    DIST_ZIPF,           // 取值频率服从Zipf分布，随机排列
+    DIST_ALL_EQUAL,      // 全部相等
+    DIST_COUNT
+} TestDistribution;
+
+// 分布参数，取0时使用括号中的默认值
+typedef struct {
+    TestDistribution distribution;
+    size_t swaps;        // 近乎有序的交换次数（n/100）
+    size_t unique;       // 少数取值/Zipf的不同取值个数（16/1024）
+    double zipf_s;       // Zipf指数（1.0）
+    uint64_t seed;       // 随机种子（20231115）
+} TestDataShape;
+
+// 测试数据声明（在test_data_generator.c中定义）
+// 默认指向生成器按元素个数分配的数组；加载数据集文件后指向文件映射
+extern size_t test_data_count;
+extern int* int_data;
+extern double* double_data;
+extern char* char_data;
+extern char (*string_data)[MAX_STRING_LEN];
+extern TestData* struct_data;
+
+// 生成n个元素的各类型数据并按分布整理，shape为NULL时均匀随机；成功返回0，内存不足返回-1
+int init_test_data_shaped(size_t n, const TestDataShape* shape);
+
+// 把任意元素数组按分布重排（先由调用方填入随机值），compar为元素的比较函数；
+// 重排所需的随机数同样只由shape->seed与抽取序号决定；成功返回0，临时内存分配失败返回-1
+int test_data_distribute(void* base, size_t n, size_t size,
+                         int (*compar)(const void*, const void*), const TestDataShape* shape);
+
+// 分布名：random sorted reverse nearly organ few zipf equal；未知名字返回-1
+int test_distribution_parse(const char* name);
+const char* test_distribution_name(TestDistribution distribution);
+
+// 解析命令行中的分布选项（--dist --swaps --unique --zipf --seed）：
+// 已处理返回1，不是分布选项返回0，取值无效返回-1
+int test_data_shape_option(const char* key, const char* value, TestDataShape* shape);
+
+// 数据集文件：生成一次后可直接映射加载，成功返回0，失败返回-1
+int test_data_save(const char* path);
+int test_data_load(const char* path, int verify);
+void test_data_unload(void);
 
 #endif // TEST_DATA_H
\ No newline at end of file
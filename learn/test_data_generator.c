@@ -17,6 +17,13 @@
 #include <time.h>
 #include <stdint.h>
 #include <math.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 typedef struct {
     char name[20];
@@ -24,87 +31,415 @@ typedef struct {
 } TestData;
 
 #include "test_data.h"
+#include "counter_rng.h"
+#include "parallel_sort.h"
 #define SEED 20231115
 
+// 各数据列与分布重排使用的随机流，同一种子下互不相关
+enum {
+    STREAM_INT = 1,
+    STREAM_DOUBLE,
+    STREAM_CHAR,
+    STREAM_STRING,
+    STREAM_STRUCT,
+    STREAM_DISTRIBUTE
+};
+
+// 并行生成时每个线程至少负责的元素个数，过小的数据集不值得开线程
+#define GENERATE_MIN_CHUNK 65536
+#define GENERATE_MAX_THREADS 64
+
 /*------------------------------------------------------
  * 函数声明区
  */
-void generate_int_data(int* arr);
-void generate_double_data(double* arr);
-void generate_char_data(char* arr);
-void generate_string_data(char arr[][MAX_STRING_LEN]);
-void generate_struct_data(TestData* arr);
+void generate_int_data(int* arr, size_t begin, size_t end, uint64_t seed);
+void generate_double_data(double* arr, size_t begin, size_t end, uint64_t seed);
+void generate_char_data(char* arr, size_t begin, size_t end, uint64_t seed);
+void generate_string_data(char arr[][MAX_STRING_LEN], size_t begin, size_t end, uint64_t seed);
+void generate_struct_data(TestData* arr, size_t begin, size_t end, uint64_t seed);
 void print_test_data();
 
 /*------------------------------------------------------
  * 全局变量区
  */
-int int_data[TEST_COUNT];
-double double_data[TEST_COUNT];
-char char_data[TEST_COUNT];
-char string_data[TEST_COUNT][MAX_STRING_LEN];
-TestData struct_data[TEST_COUNT];
+// 生成器按元素个数分配的存储；对外通过指针访问，以便切换到数据集文件映射
+static size_t storage_count = 0;
+static uint64_t storage_seed = SEED;
+static TestDistribution storage_distribution = DIST_RANDOM;
+static int* int_storage = NULL;
+static double* double_storage = NULL;
+static char* char_storage = NULL;
+static char (*string_storage)[MAX_STRING_LEN] = NULL;
+static TestData* struct_storage = NULL;
+
+size_t test_data_count = 0;
+int* int_data = NULL;
+double* double_data = NULL;
+char* char_data = NULL;
+char (*string_data)[MAX_STRING_LEN] = NULL;
+TestData* struct_data = NULL;
+
+static void test_data_storage_free(void) {
+    free(int_storage);
+    free(double_storage);
+    free(char_storage);
+    free(string_storage);
+    free(struct_storage);
+    int_storage = NULL;
+    double_storage = NULL;
+    char_storage = NULL;
+    string_storage = NULL;
+    struct_storage = NULL;
+    storage_count = 0;
+}
+
+// 清零分配：字符串与名字末尾的填充字节固定为0，数据集文件的校验和可复现
+static int test_data_storage_alloc(size_t n) {
+    size_t slots = n ? n : 1;
+    test_data_storage_free();
+    int_storage = calloc(slots, sizeof(int));
+    double_storage = calloc(slots, sizeof(double));
+    char_storage = calloc(slots, sizeof(char));
+    string_storage = calloc(slots, MAX_STRING_LEN);
+    struct_storage = calloc(slots, sizeof(TestData));
+    if(!int_storage || !double_storage || !char_storage || !string_storage || !struct_storage) {
+        test_data_storage_free();
+        return -1;
+    }
+    storage_count = n;
+    return 0;
+}
+
+/*------------------------------------------------------
+ * 分布函数
+ * 先填入随机值，再按分布重排或替换，与元素类型无关
+ */
+static const char* const distribution_names[DIST_COUNT] = {
+    "random", "sorted", "reverse", "nearly", "organ", "few", "zipf", "equal"
+};
+
+#define DIST_DEFAULT_FEW_UNIQUE 16
+#define DIST_DEFAULT_ZIPF_UNIQUE 1024
+
+static int compare_int_value(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_double_value(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_char_value(const void* a, const void* b) {
+    return *(const char*)a - *(const char*)b;
+}
+
+static int compare_string_row(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+static int compare_struct_value(const void* a, const void* b) {
+    const TestData* x = a;
+    const TestData* y = b;
+    int c = strcmp(x->name, y->name);
+    if(c != 0) return c;
+    return (x->hash > y->hash) - (x->hash < y->hash);
+}
+
+// 第index次抽取的随机数生成器，只由种子与抽取序号决定
+static void dist_rng(CounterRng* rng, uint64_t seed, size_t index) {
+    counter_rng_init(rng, seed, STREAM_DISTRIBUTE, index);
+}
+
+#define DIST_ELEM(base, i, size) ((char*)(base) + (size_t)(i) * (size))
+
+static void dist_swap(void* base, size_t i, size_t j, size_t size, char* tmp) {
+    memcpy(tmp, DIST_ELEM(base, i, size), size);
+    memcpy(DIST_ELEM(base, i, size), DIST_ELEM(base, j, size), size);
+    memcpy(DIST_ELEM(base, j, size), tmp, size);
+}
+
+// 前unique个随机值作为取值集合，每个元素按累积权重cdf抽取其一（cdf为NULL时等概率）
+static int dist_fill_from_pool(void* base, size_t n, size_t size, size_t unique, const double* cdf,
+                               uint64_t seed) {
+    char* pool = malloc(unique * size);
+    if(!pool) return -1;
+    memcpy(pool, base, unique * size);
+    for(size_t i = 0; i < n; i++) {
+        CounterRng rng;
+        size_t k;
+        dist_rng(&rng, seed, i);
+        if(!cdf) {
+            k = (size_t)counter_rng_below(&rng, unique);
+        } else {
+            // 二分查找第一个累积权重不小于u的取值
+            double u = counter_rng_unit(&rng) * cdf[unique - 1];
+            size_t lo = 0, hi = unique - 1;
+            while(lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if(cdf[mid] < u) lo = mid + 1;
+                else hi = mid;
+            }
+            k = lo;
+        }
+        memcpy(DIST_ELEM(base, i, size), pool + k * size, size);
+    }
+    free(pool);
+    return 0;
+}
+
+// 第k个取值的权重为1/(k+1)^s
+static int dist_fill_zipf(void* base, size_t n, size_t size, size_t unique, double s, uint64_t seed) {
+    double* cdf = malloc(unique * sizeof(double));
+    if(!cdf) return -1;
+    double sum = 0;
+    for(size_t k = 0; k < unique; k++) {
+        sum += 1.0 / pow((double)(k + 1), s);
+        cdf[k] = sum;
+    }
+    int rc = dist_fill_from_pool(base, n, size, unique, cdf, seed);
+    free(cdf);
+    return rc;
+}
+
+// 有序序列的偶数秩依次放在前半，奇数秩从末尾向前放，形成先升后降
+static int dist_organ_pipe(void* base, size_t n, size_t size) {
+    char* sorted = malloc(n * size);
+    if(!sorted) return -1;
+    memcpy(sorted, base, n * size);
+    for(size_t r = 0; r < n; r++) {
+        size_t pos = (r % 2 == 0) ? r / 2 : n - 1 - r / 2;
+        memcpy(DIST_ELEM(base, pos, size), sorted + r * size, size);
+    }
+    free(sorted);
+    return 0;
+}
+
+int test_data_distribute(void* base, size_t n, size_t size,
+                         int (*compar)(const void*, const void*), const TestDataShape* shape) {
+    if(!shape || n < 2) return 0;
+    uint64_t seed = shape->seed ? shape->seed : SEED;
+    char* tmp = malloc(size);
+    if(!tmp) return -1;
+    int rc = 0;
+
+    switch(shape->distribution) {
+        case DIST_SORTED:
+            qsort(base, n, size, compar);
+            break;
+        case DIST_REVERSE:
+            qsort(base, n, size, compar);
+            for(size_t i = 0, j = n - 1; i < j; i++, j--)
+                dist_swap(base, i, j, size, tmp);
+            break;
+        case DIST_NEARLY_SORTED: {
+            size_t swaps = shape->swaps ? shape->swaps : n / 100;
+            qsort(base, n, size, compar);
+            for(size_t k = 0; k < swaps; k++) {
+                CounterRng rng;
+                dist_rng(&rng, seed, k);
+                size_t i = (size_t)counter_rng_below(&rng, n);
+                size_t j = (size_t)counter_rng_below(&rng, n);
+                dist_swap(base, i, j, size, tmp);
+            }
+            break;
+        }
+        case DIST_ORGAN_PIPE:
+            qsort(base, n, size, compar);
+            rc = dist_organ_pipe(base, n, size);
+            break;
+        case DIST_FEW_UNIQUE: {
+            size_t unique = shape->unique ? shape->unique : DIST_DEFAULT_FEW_UNIQUE;
+            rc = dist_fill_from_pool(base, n, size, unique < n ? unique : n, NULL, seed);
+            break;
+        }
+        case DIST_ZIPF: {
+            size_t unique = shape->unique ? shape->unique : DIST_DEFAULT_ZIPF_UNIQUE;
+            double s = shape->zipf_s > 0 ? shape->zipf_s : 1.0;
+            rc = dist_fill_zipf(base, n, size, unique < n ? unique : n, s, seed);
+            break;
+        }
+        case DIST_ALL_EQUAL:
+            for(size_t i = 1; i < n; i++)
+                memcpy(DIST_ELEM(base, i, size), base, size);
+            break;
+        default:
+            break;
+    }
+    free(tmp);
+    return rc;
+}
+
+int test_distribution_parse(const char* name) {
+    for(int i = 0; i < DIST_COUNT; i++)
+        if(strcmp(distribution_names[i], name) == 0) return i;
+    return -1;
+}
+
+const char* test_distribution_name(TestDistribution distribution) {
+    return (unsigned)distribution < DIST_COUNT ? distribution_names[distribution] : "?";
+}
+
+int test_data_shape_option(const char* key, const char* value, TestDataShape* shape) {
+    char* end;
+    if(strcmp(key, "--dist") == 0) {
+        int d = test_distribution_parse(value);
+        if(d < 0) return -1;
+        shape->distribution = (TestDistribution)d;
+    } else if(strcmp(key, "--swaps") == 0 || strcmp(key, "--unique") == 0) {
+        unsigned long long v = strtoull(value, &end, 10);
+        if(*value < '0' || *value > '9' || *end != '\0') return -1;
+        if(key[2] == 's') shape->swaps = (size_t)v;
+        else shape->unique = (size_t)v;
+    } else if(strcmp(key, "--zipf") == 0) {
+        double s = strtod(value, &end);
+        if(end == value || *end != '\0' || !(s > 0)) return -1;
+        shape->zipf_s = s;
+    } else if(strcmp(key, "--seed") == 0) {
+        unsigned long long v = strtoull(value, &end, 10);
+        if(*value < '0' || *value > '9' || *end != '\0' || v == 0) return -1;
+        shape->seed = (uint64_t)v;
+    } else {
+        return 0;
+    }
+    return 1;
+}
 
 /*------------------------------------------------------
  * 初始化函数
  */
 void init_test_data() {
-    srand(SEED);
-    
+    if(init_test_data_shaped(TEST_COUNT, NULL) != 0) {
+        fprintf(stderr, "测试数据内存分配失败\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* 生成区间[begin, end)的各列数据 */
+typedef struct {
+    size_t begin, end;
+    uint64_t seed;
+} GenerateChunk;
+
+static void generate_chunk(const GenerateChunk* chunk) {
+    generate_int_data(int_data, chunk->begin, chunk->end, chunk->seed);
+    generate_double_data(double_data, chunk->begin, chunk->end, chunk->seed);
+    generate_char_data(char_data, chunk->begin, chunk->end, chunk->seed);
+    generate_string_data(string_data, chunk->begin, chunk->end, chunk->seed);
+    generate_struct_data(struct_data, chunk->begin, chunk->end, chunk->seed);
+}
+
+static void* generate_chunk_thread(void* arg) {
+    generate_chunk(arg);
+    return NULL;
+}
+
+/* 按线程切分[0, n)并行生成；线程创建失败的区间由当前线程补上 */
+static void generate_parallel(size_t n, uint64_t seed) {
+    pthread_t tids[GENERATE_MAX_THREADS];
+    GenerateChunk chunks[GENERATE_MAX_THREADS];
+    int started[GENERATE_MAX_THREADS];
+    size_t threads = (size_t)parallel_sort_default_threads();
+    if(threads > GENERATE_MAX_THREADS) threads = GENERATE_MAX_THREADS;
+    if(threads > n / GENERATE_MIN_CHUNK) threads = n / GENERATE_MIN_CHUNK;
+    if(threads < 2) {
+        GenerateChunk all = { 0, n, seed };
+        generate_chunk(&all);
+        return;
+    }
+
+    for(size_t t = 0; t < threads; t++) {
+        chunks[t].begin = n / threads * t;
+        chunks[t].end = t + 1 == threads ? n : n / threads * (t + 1);
+        chunks[t].seed = seed;
+        started[t] = pthread_create(&tids[t], NULL, generate_chunk_thread, &chunks[t]) == 0;
+    }
+    for(size_t t = 0; t < threads; t++) {
+        if(started[t]) pthread_join(tids[t], NULL);
+        else generate_chunk(&chunks[t]);
+    }
+}
+
+/* 各类型先按种子生成均匀随机值，再按分布重排；
+ * 第i个元素只取决于(种子, 列, i)，与线程数和C库的rand()实现无关 */
+int init_test_data_shaped(size_t n, const TestDataShape* shape) {
+    test_data_unload();
+    if(test_data_storage_alloc(n) != 0) return -1;
+    storage_seed = shape && shape->seed ? shape->seed : SEED;
+    test_data_unload();
+
     // 生成测试数据
-    generate_int_data(int_data);
-    generate_double_data(double_data);
-    generate_char_data(char_data);
-    generate_string_data(string_data);
-    generate_struct_data(struct_data);
+    generate_parallel(n, storage_seed);
+
+    storage_distribution = shape ? shape->distribution : DIST_RANDOM;
+    if(storage_distribution != DIST_RANDOM
+       && (test_data_distribute(int_data, n, sizeof(int), compare_int_value, shape) != 0
+           || test_data_distribute(double_data, n, sizeof(double), compare_double_value, shape) != 0
+           || test_data_distribute(char_data, n, sizeof(char), compare_char_value, shape) != 0
+           || test_data_distribute(string_data, n, MAX_STRING_LEN, compare_string_row, shape) != 0
+           || test_data_distribute(struct_data, n, sizeof(TestData), compare_struct_value, shape) != 0))
+        return -1;
+    return 0;
 }
 
 /*------------------------------------------------------
  * 生成函数实现
+ * 每个元素以(种子, 列, 下标)初始化自己的计数器随机数
  */
-void generate_int_data(int* arr) {
-    for(int i = 0; i < TEST_COUNT; i++) {
+void generate_int_data(int* arr, size_t begin, size_t end, uint64_t seed) {
+    for(size_t i = begin; i < end; i++) {
+        CounterRng rng;
+        counter_rng_init(&rng, seed, STREAM_INT, i);
         // 生成范围：-2^31到2^31-1
-        arr[i] = (rand() % 0x80000000) | ((rand() % 0x80000000) << 31);
+        arr[i] = (int)(uint32_t)counter_rng_next(&rng);
     }
 }
 
-void generate_double_data(double* arr) {
-    for(int i = 0; i < TEST_COUNT; i++) {
+void generate_double_data(double* arr, size_t begin, size_t end, uint64_t seed) {
+    for(size_t i = begin; i < end; i++) {
+        CounterRng rng;
+        counter_rng_init(&rng, seed, STREAM_DOUBLE, i);
         // 生成范围：-1e38到1e38，保留15位有效数字
-        double exponent = (rand() % 400) - 200; // ±200 exponent
-        double mantissa = (rand() / (double)RAND_MAX) * 1e15;
+        double exponent = (double)counter_rng_below(&rng, 400) - 200; // ±200 exponent
+        double mantissa = counter_rng_unit(&rng) * 1e15;
         arr[i] = mantissa * pow(10, exponent);
     }
 }
 
-void generate_char_data(char* arr) {
-    for(int i = 0; i < TEST_COUNT; i++) {
+void generate_char_data(char* arr, size_t begin, size_t end, uint64_t seed) {
+    for(size_t i = begin; i < end; i++) {
+        CounterRng rng;
+        counter_rng_init(&rng, seed, STREAM_CHAR, i);
         // 生成ASCII字符：0x20(空格)到0x7E(~)
-        arr[i] = 0x20 + (rand() % 0x5E);
+        arr[i] = 0x20 + (char)counter_rng_below(&rng, 0x5E);
     }
 }
 
-void generate_string_data(char arr[][MAX_STRING_LEN]) {
+void generate_string_data(char arr[][MAX_STRING_LEN], size_t begin, size_t end, uint64_t seed) {
     const char charset[] = "abcdefghijklmnopqrstuvwxyz"
                           "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
                           "0123456789!@#$%^&*()";
-    for(int i = 0; i < TEST_COUNT; i++) {
-        int len = 5 + (rand() % 14); // 5-18字符
+    for(size_t i = begin; i < end; i++) {
+        CounterRng rng;
+        counter_rng_init(&rng, seed, STREAM_STRING, i);
+        int len = 5 + (int)counter_rng_below(&rng, 14); // 5-18字符
         for(int j = 0; j < len; j++) {
-            arr[i][j] = charset[rand() % (sizeof(charset)-1)];
+            arr[i][j] = charset[counter_rng_below(&rng, sizeof(charset)-1)];
         }
         arr[i][len] = '\0';
     }
 }
 
-void generate_struct_data(TestData* arr) {
+void generate_struct_data(TestData* arr, size_t begin, size_t end, uint64_t seed) {
     const char* names[] = {
         "Apple", "Banana", "Cherry", "Date", "Elderberry"
     };
-    for(int i = 0; i < TEST_COUNT; i++) {
-        strcpy(arr[i].name, names[rand() % FRUIT_TYPES]);
-        arr[i].hash = rand(); // 随机哈希值，在排序时会被MD5替换
+    for(size_t i = begin; i < end; i++) {
+        CounterRng rng;
+        counter_rng_init(&rng, seed, STREAM_STRUCT, i);
+        strcpy(arr[i].name, names[counter_rng_below(&rng, FRUIT_TYPES)]);
+        arr[i].hash = (uint32_t)counter_rng_next(&rng); // 随机哈希值，在排序时会被MD5替换
     }
 }
 
@@ -116,33 +451,260 @@ void print_test_data() {
     
     // 整型数据
     printf("\n整数数据（前10个）:\n");
-    for(int i = 0; i < 10; i++) {
+    for(int i = 0; i < 10 && (size_t)i < test_data_count; i++) {
         printf("%d: 0x%08X (%+d)\n", 
             i, int_data[i], int_data[i]);
     }
     
     // 双精度数据
     printf("\n双精度数据（前10个）:\n");
-    for(int i = 0; i < 10; i++) {
+    for(int i = 0; i < 10 && (size_t)i < test_data_count; i++) {
         printf("%d: %.3e\n", i, double_data[i]);
     }
     
     // 字符数据
     printf("\n字符数据（前10个）:\n");
-    for(int i = 0; i < 10; i++) {
+    for(int i = 0; i < 10 && (size_t)i < test_data_count; i++) {
         printf("%d: 0x%02X '%c'\n", i, char_data[i], char_data[i]);
     }
     
     // 字符串数据
     printf("\n字符串数据（前5个）:\n");
-    for(int i = 0; i < 5; i++) {
+    for(int i = 0; i < 5 && (size_t)i < test_data_count; i++) {
         printf("%d: \"%s\" (len=%d)\n", i, string_data[i], (int)strlen(string_data[i]));
     }
     
     // 结构体数据
     printf("\n结构体数据（前5个）:\n");
-    for(int i = 0; i < 5; i++) {
+    for(int i = 0; i < 5 && (size_t)i < test_data_count; i++) {
         printf("%d: %s (hash=0x%08X)\n", 
             i, struct_data[i].name, struct_data[i].hash);
     }
 }
+
+/*------------------------------------------------------
+ * 数据集文件
+ * 布局：文件头 | 各列数据（每列起始按64字节对齐）
+ * 列数据即内存中的数组原样写出，加载后可直接在映射上读取和排序；
+ * 文件按写出机器的字节序存储，byte_order字段用于拒绝字节序不同的文件。
+ * 生成器与平台无关，同一种子在任何机器上得到相同数据；文件省去的是生成与哈希的时间。
+ */
+#define DATASET_MAGIC "SORTDSET"
+#define DATASET_VERSION 1
+#define DATASET_BYTE_ORDER 0x01020304u
+#define DATASET_COLUMNS 5
+#define DATASET_ALIGN 64
+
+// 列类型编号，与列在文件头中的位置一致
+enum {
+    DATASET_COL_INT = 1,
+    DATASET_COL_DOUBLE,
+    DATASET_COL_CHAR,
+    DATASET_COL_STRING,
+    DATASET_COL_STRUCT
+};
+
+typedef struct {
+    uint32_t type;
+    uint32_t elem_size;
+    uint64_t offset;     // 相对文件开头
+    uint64_t bytes;
+    uint64_t checksum;   // 列数据的FNV-1a 64位校验和
+} DatasetColumn;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t seed;
+    uint64_t count;
+    uint32_t column_count;
+    uint32_t distribution; // TestDistribution，旧文件中为0即均匀随机
+    DatasetColumn columns[DATASET_COLUMNS];
+} DatasetHeader;
+
+static const uint32_t dataset_elem_sizes[DATASET_COLUMNS] = {
+    sizeof(int), sizeof(double), sizeof(char), MAX_STRING_LEN, sizeof(TestData)
+};
+
+static void* dataset_base = NULL;    // 当前加载的数据集映射
+static size_t dataset_size = 0;
+static uint64_t dataset_seed = SEED;
+static uint32_t dataset_distribution = DIST_RANDOM;
+
+static uint64_t dataset_align(uint64_t offset) {
+    return (offset + DATASET_ALIGN - 1) & ~(uint64_t)(DATASET_ALIGN - 1);
+}
+
+static uint64_t dataset_checksum(const void* data, size_t len) {
+    const unsigned char* p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* count行、每行row_size字节，每行从field开始的field_size字节内必须出现'\0' */
+static int dataset_rows_terminated(const char* rows, uint64_t count, size_t row_size,
+                                   size_t field, size_t field_size) {
+    for(uint64_t i = 0; i < count; i++)
+        if(!memchr(rows + i * row_size + field, '\0', field_size)) return 0;
+    return 1;
+}
+
+/* 私有可写映射：排序时写时复制，不会改动文件 */
+static void* dataset_map_file(const char* path, size_t* size) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return NULL;
+    void* base = NULL;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if(base == MAP_FAILED)
+            base = NULL;
+        else
+            *size = (size_t)st.st_size;
+    }
+    close(fd);
+    return base;
+#else
+    // 没有mmap的平台整体读入内存
+    FILE* fp = fopen(path, "rb");
+    if(!fp) return NULL;
+    void* base = NULL;
+    long len = -1;
+    if(fseek(fp, 0, SEEK_END) == 0) len = ftell(fp);
+    if(len > 0 && fseek(fp, 0, SEEK_SET) == 0 && (base = malloc((size_t)len)) != NULL) {
+        if(fread(base, 1, (size_t)len, fp) == (size_t)len) {
+            *size = (size_t)len;
+        } else {
+            free(base);
+            base = NULL;
+        }
+    }
+    fclose(fp);
+    return base;
+#endif
+}
+
+static void dataset_unmap_file(void* base, size_t size) {
+#ifndef _WIN32
+    munmap(base, size);
+#else
+    (void)size;
+    free(base);
+#endif
+}
+
+int test_data_save(const char* path) {
+    const void* columns[DATASET_COLUMNS] = {
+        int_data, double_data, char_data, string_data, struct_data
+    };
+    DatasetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.version = DATASET_VERSION;
+    header.byte_order = DATASET_BYTE_ORDER;
+    header.seed = dataset_seed;
+    header.count = test_data_count;
+    header.column_count = DATASET_COLUMNS;
+    header.distribution = dataset_base ? dataset_distribution : (uint32_t)storage_distribution;
+
+    uint64_t offset = dataset_align(sizeof(header));
+    for(int c = 0; c < DATASET_COLUMNS; c++) {
+        DatasetColumn* col = &header.columns[c];
+        col->type = DATASET_COL_INT + c;
+        col->elem_size = dataset_elem_sizes[c];
+        col->offset = offset;
+        col->bytes = (uint64_t)test_data_count * col->elem_size;
+        col->checksum = dataset_checksum(columns[c], col->bytes);
+        offset = dataset_align(offset + col->bytes);
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if(!fp) return -1;
+
+    static const char padding[DATASET_ALIGN];
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    uint64_t pos = sizeof(header);
+    for(int c = 0; c < DATASET_COLUMNS && ok; c++) {
+        const DatasetColumn* col = &header.columns[c];
+        size_t pad = (size_t)(col->offset - pos);
+        ok = fwrite(padding, 1, pad, fp) == pad
+          && fwrite(columns[c], 1, col->bytes, fp) == col->bytes;
+        pos = col->offset + col->bytes;
+    }
+    if(fclose(fp) != 0) ok = 0;
+    if(!ok) remove(path);
+    return ok ? 0 : -1;
+}
+
+int test_data_load(const char* path, int verify) {
+    size_t size = 0;
+    char* base = dataset_map_file(path, &size);
+    if(!base) return -1;
+
+    // 每个元素至少1字节，count不超过文件长度，后续乘法不会溢出
+    const DatasetHeader* header = (const DatasetHeader*)base;
+    if(size < sizeof(*header)
+       || memcmp(header->magic, DATASET_MAGIC, sizeof(header->magic)) != 0
+       || header->version != DATASET_VERSION
+       || header->byte_order != DATASET_BYTE_ORDER
+       || header->count > size
+       || header->column_count != DATASET_COLUMNS)
+        goto fail;
+
+    void* columns[DATASET_COLUMNS];
+    for(int c = 0; c < DATASET_COLUMNS; c++) {
+        const DatasetColumn* col = &header->columns[c];
+        if(col->type != (uint32_t)(DATASET_COL_INT + c)
+           || col->elem_size != dataset_elem_sizes[c]
+           || col->bytes != header->count * col->elem_size
+           || col->offset % DATASET_ALIGN != 0
+           || col->offset > size || col->bytes > size - col->offset)
+            goto fail;
+        if(verify && dataset_checksum(base + col->offset, col->bytes) != col->checksum)
+            goto fail;
+        columns[c] = base + col->offset;
+    }
+    // 校验和只说明文件自洽，字符串列还要逐行确认有结尾的'\0'，否则后续strlen/strcmp会越界
+    if(!dataset_rows_terminated(columns[3], header->count, MAX_STRING_LEN, 0, MAX_STRING_LEN)
+       || !dataset_rows_terminated(columns[4], header->count, sizeof(TestData),
+                                   offsetof(TestData, name), sizeof(((TestData*)0)->name)))
+        goto fail;
+
+    test_data_unload();
+    dataset_base = base;
+    dataset_size = size;
+    dataset_seed = header->seed;
+    dataset_distribution = header->distribution;
+    test_data_count = (size_t)header->count;
+    int_data = columns[0];
+    double_data = columns[1];
+    char_data = columns[2];
+    string_data = columns[3];
+    struct_data = columns[4];
+    return 0;
+
+fail:
+    dataset_unmap_file(base, size);
+    return -1;
+}
+
+void test_data_unload(void) {
+    if(dataset_base) {
+        dataset_unmap_file(dataset_base, dataset_size);
+        dataset_base = NULL;
+        dataset_size = 0;
+    }
+    dataset_seed = storage_seed;
+    test_data_count = storage_count;
+    int_data = int_storage;
+    double_data = double_storage;
+    char_data = char_storage;
+    string_data = string_storage;
+    struct_data = struct_storage;
+}
@@ -0,0 +1,109 @@
+/* timer.c - 高精度分阶段计时 */
+#include <stdlib.h>
+#include <time.h>
+#include "timer.h"
+
+#if defined(TIMER_USE_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define TIMER_RDTSC 1
+#endif
+
+/* rdtsc频率校准时长（纳秒） */
+#define TIMER_CALIBRATE_NS 20000000ULL
+
+static uint64_t timer_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#ifdef TIMER_RDTSC
+static double timer_tick_seconds = 0;
+
+/* 忙等一小段时间，用单调时钟换算时间戳计数器的频率 */
+static void timer_calibrate(void) {
+    uint64_t ns0 = timer_monotonic_ns();
+    uint64_t tsc0 = __rdtsc();
+    uint64_t ns1;
+    do {
+        ns1 = timer_monotonic_ns();
+    } while (ns1 - ns0 < TIMER_CALIBRATE_NS);
+    uint64_t tsc1 = __rdtsc();
+    timer_tick_seconds = (double)(ns1 - ns0) * 1e-9 / (double)(tsc1 - tsc0);
+}
+#endif
+
+uint64_t timer_now(void) {
+#ifdef TIMER_RDTSC
+    return __rdtsc();
+#else
+    return timer_monotonic_ns();
+#endif
+}
+
+double timer_seconds(uint64_t ticks) {
+#ifdef TIMER_RDTSC
+    if (timer_tick_seconds == 0) timer_calibrate();
+    return (double)ticks * timer_tick_seconds;
+#else
+    return (double)ticks * 1e-9;
+#endif
+}
+
+const char* timer_source(void) {
+#ifdef TIMER_RDTSC
+    return "rdtsc";
+#else
+    return "clock_monotonic";
+#endif
+}
+
+/* ===================== 阶段采样 ===================== */
+void timer_phase_init(TimerPhase* phase, const char* name) {
+    phase->name = name;
+    phase->samples = NULL;
+    phase->count = 0;
+    phase->capacity = 0;
+}
+
+void timer_phase_free(TimerPhase* phase) {
+    free(phase->samples);
+    timer_phase_init(phase, phase->name);
+}
+
+void timer_phase_clear(TimerPhase* phase) {
+    phase->count = 0;
+}
+
+int timer_phase_add(TimerPhase* phase, double seconds) {
+    if (phase->count == phase->capacity) {
+        size_t new_cap = phase->capacity ? phase->capacity * 2 : 16;
+        double* samples = realloc(phase->samples, new_cap * sizeof(double));
+        if (!samples) return -1;
+        phase->samples = samples;
+        phase->capacity = new_cap;
+    }
+    phase->samples[phase->count++] = seconds;
+    return 0;
+}
+
+static int timer_compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void timer_phase_stats(TimerPhase* phase, TimerStats* stats) {
+    size_t n = phase->count;
+    stats->count = n;
+    stats->total = stats->min = stats->median = stats->p99 = stats->max = 0;
+    if (n == 0) return;
+
+    double* s = phase->samples;
+    qsort(s, n, sizeof(double), timer_compare_double);
+    for (size_t i = 0; i < n; i++)
+        stats->total += s[i];
+    stats->min = s[0];
+    stats->max = s[n - 1];
+    stats->median = (n % 2) ? s[n / 2] : (s[n / 2 - 1] + s[n / 2]) / 2;
+    stats->p99 = s[(99 * n + 99) / 100 - 1];
+}
@@ -0,0 +1,41 @@
+/* timer.h - 高精度分阶段计时 */
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* 当前时刻的计时单位数：默认为CLOCK_MONOTONIC纳秒；
+ * 以-DTIMER_USE_RDTSC编译时在x86上读取时间戳计数器 */
+uint64_t timer_now(void);
+/* 计时单位差值换算为秒（rdtsc首次换算时对照单调时钟校准频率） */
+double timer_seconds(uint64_t ticks);
+/* 计时源名称，用于报告 */
+const char* timer_source(void);
+
+/* 一个阶段的多次采样（秒） */
+typedef struct {
+    const char* name;
+    double* samples;
+    size_t count;
+    size_t capacity;
+} TimerPhase;
+
+typedef struct {
+    size_t count;
+    double total;
+    double min;
+    double median;
+    double p99;          /* 最近秩法 */
+    double max;
+} TimerStats;
+
+void timer_phase_init(TimerPhase* phase, const char* name);
+void timer_phase_free(TimerPhase* phase);
+void timer_phase_clear(TimerPhase* phase);
+/* 成功返回0，内存不足返回-1 */
+int timer_phase_add(TimerPhase* phase, double seconds);
+/* 统计采样分布；会把samples按升序排列，count为0时各项为0 */
+void timer_phase_stats(TimerPhase* phase, TimerStats* stats);
+
+#endif /* TIMER_H */